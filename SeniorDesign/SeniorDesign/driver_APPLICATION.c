@@ -11,13 +11,85 @@
 uint16_t APP_course2rot();
 int16_t APP_lastSuper2rot();
 void APP_update_MASTER();
+void APP_update_clock();
+void APP_onFix(const GPS_data * fix);
+void APP_onFix_trace(const GPS_data * fix);
+void APP_wait_fix();
+void APP_governRate();
 void APP_DGPS_incTime();
+void APP_print_fix();
 void APP_setUpdateState(uint8_t state);
+uint8_t APP_append_node(NodeRecord * node, uint32_t time);
+uint8_t APP_manifest_put(uint16_t eid, const ManifestEntry * entry);
+uint8_t APP_checkpoint(uint8_t force);
+uint8_t APP_checkpoint_recover();
+uint8_t APP_manifest_rescan();
+uint16_t APP_crc16(const uint8_t * src, uint16_t len);
+uint8_t APP_mount();
+void APP_trip_update();
+uint8_t APP_sign_card();
+uint8_t APP_simplify_push(Vector2 off, uint32_t time);
+uint8_t APP_simplify_deviates(Vector2 off);
+uint8_t APP_simplify_flush();
+uint8_t APP_close_visit();
+uint32_t APP_find_router(uint32_t directory, Vector2 quad, uint8_t * created);
+uint8_t APP_create_directory(uint32_t sector);
+void APP_index_push(const NodeRecord * node, uint32_t addr);
+uint8_t APP_index_flush();
+uint8_t APP_index_within(uint32_t directory, int32_t x, int32_t y, uint16_t radius, IndexHit * hits, uint8_t max);
+void APP_shift_frame(int16_t dx, int16_t dy);
+void APP_startMode_retracing(uint8_t forward);
+uint8_t APP_retrace_open(uint16_t eid, uint8_t forward);
+void APP_retrace_prefetch();
+void APP_retrace_queue(const NodePage * page, uint8_t first, uint8_t n);
+void APP_retrace_draw(const RetraceNode * node, Color color);
+uint8_t APP_retrace_near(const RetraceNode * a, const RetraceNode * b, const RetraceNode * p);
+int16_t APP_target2rot(int32_t dx, int32_t dy);
+uint8_t APP_draw_router(uint32_t quadSector, uint8_t resident);
+uint8_t APP_draw_extent(const RouterExtent * ext);
+uint8_t APP_draw_view();
+uint8_t APP_view_quadrant(Vector2 quad);
+void APP_view_clear(int16_t x, int16_t y, int16_t w, int16_t h);
+uint8_t APP_tile_merge();
+uint8_t APP_tile_header(uint32_t sector, uint16_t gen, uint32_t data, uint16_t bytes);
+uint8_t APP_tile_stale(uint32_t quadSector, uint16_t gen);
+uint8_t APP_tile_blit(uint32_t quadSector, uint16_t gen, int16_t sx, int16_t sy);
+void APP_tile_paint(const TileNode * node, int16_t row);
+uint8_t APP_tile_put(uint8_t run);
+uint8_t APP_journal_flush();
+uint8_t * APP_put_varint(uint8_t * dst, uint32_t val);
+const uint8_t * APP_get_varint(const uint8_t * src, uint32_t * val);
+uint8_t * APP_encode_node(uint8_t * dst, const NodeRecord * node, uint8_t key);
+const uint8_t * APP_decode_node(const uint8_t * src, NodeRecord * node);
+void APP_draw_node(const NodeRecord * node);
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //										APP Driver Objects										  //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 SettingHandler settings;
 TraceHandler trace;
+GPS_data gps;
+volatile uint8_t updateDue = 0;
+uint8_t updatesOn = 0;
+uint8_t journalResident = 0;		// Live page is staged in disk.buff
+uint8_t journalDirty = 0;			// Staged page holds records not yet on the card
+uint8_t journalKey = 1;				// Next record must be a key (no valid 'journalLast')
+NodeRecord journalLast;				// Last record appended (delta base)
+SimplifyHandler simplify;
+RetraceHandler retrace;
+SharedBuffers shared;				// Retrace ring, or the open visit's pending buffers
+uint32_t journalPrev = 0;			// Page the live page continues from
+uint8_t indexPendingCount = 0;
+uint8_t tilePendingCount = 0;
+uint8_t tileOn = 0;					// Open visit's tile is up to date with all but 'tilePending'
+uint16_t tileBase;					// Router generation when the visit opened
+uint16_t tileGen;					// Generation of the tile on the card
+uint8_t tileRow[DAT_TILE_ROWBYTES];	// Pane row being merged (palette indices)
+uint32_t tileData;					// Tile being written: first sector of runs
+uint16_t tileBytes;					// ...and bytes of runs so far
+Vector2 drawShift = {0,0};			// Screen shift of the quadrant being drawn into the view [px]
+uint32_t checkpointSeq = 0;			// Sequence number of the last checkpoint
+uint32_t checkpointLimit = 0;		// ...and the sector it lets 'freeSector' run up to
+uint8_t checkpointDue = 0;			// State worth a checkpoint changed since
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //									   APP Public Functions										  //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -33,6 +105,8 @@ void APP_loadProgram_fast()
 	LCD_init();
 	SFX_init();				
 	GPS_configure_firmware();
+	GPS_subscribe(APP_onFix,1);
+	GPS_subscribe(APP_onFix_trace,GPS_RATE_HZ(GPS_get_rate()) * TRACE_PERIOD);
 	KEY_init();					
 	APP_formatCard();
 	
@@ -41,7 +115,7 @@ void APP_loadProgram_fast()
 	TCCR0A = (1<<WGM01);						// Timer 0: Mode = "CTC"
 	TCCR0B = (1<<CS01)|(1<<CS00);				// Timer 0: N = 64
 	TIMSK0 |= (1<<OCIE0A);						// Enable Timer 0 CMPA interrupt
-	APP_startMode_main();
+	APP_startMode_resume();
 	sei();
 }
 
@@ -57,27 +131,29 @@ void APP_loadProgram()
 	
 	/* Print Brand */
 	LCD_drawLogo(LOADSCREEN_LOGO_XOFF,LOADSCREEN_LOGO_YOFF,LOADSCREEN_LOGO_SIZE);
-	LCD_print_str("Power Couple TM\n");
+	LCD_print_str_P(PSTR("Power Couple TM\n"));
 	
 	/* Initialize Drivers */
 	pencil.fg = LOADSCREEN_TEXT_COLOR;
-	LCD_print_str("Initializing SFX...\n");		SFX_init();					// Initialize SFX 
+	LCD_print_str_P(PSTR("Initializing SFX...\n"));		SFX_init();					// Initialize SFX 
 	LCD_setIconState(GPSICON,1);											// Set active GPS icon
-	LCD_print_str("Initializing GPS...\n");		GPS_configure_firmware();	// Initialize GPS
+	LCD_print_str_P(PSTR("Initializing GPS...\n"));		GPS_configure_firmware();	// Initialize GPS
+	GPS_subscribe(APP_onFix,1);												// Screens: every fix
+	GPS_subscribe(APP_onFix_trace,GPS_RATE_HZ(GPS_get_rate()) * TRACE_PERIOD);	// Trace writer: decimated
 	LCD_setIconState(GPSICON,0);											// Set inactive GPS icon
 	LCD_setIconState(CARDICON,1);											// Set active card icon
-	LCD_print_str("Initializing Disk...\n");	DISK_init();				// Initialize disk
+	LCD_print_str_P(PSTR("Initializing Disk...\n"));	DISK_init();				// Initialize disk
 	LCD_setIconState(CARDICON,0);											// Set inactive card icon
 	
 	/* Format/Load from Card */
-	LCD_print_str("Checking Signature...\n");
+	LCD_print_str_P(PSTR("Checking Signature...\n"));
 	if(APP_formatCard()) 
-	LCD_print_str("Formatting Done...\n");
+	LCD_print_str_P(PSTR("Formatting Done...\n"));
 	else                
-	LCD_print_str("Data Loaded...\n");	
+	LCD_print_str_P(PSTR("Data Loaded...\n"));	
 	
 	/* Configure Update Settings */				// ***
-	LCD_print_str("Configuring System...\n");	// Print test
+	LCD_print_str_P(PSTR("Configuring System...\n"));	// Print test
 	OCR0A = 1000 / 8;							// Timer 0: CTC Period = 1 ms
 	TCCR0A = (1<<WGM01);						// Timer 0: Mode = "CTC"
 	TCCR0B = (1<<CS01)|(1<<CS00);				// Timer 0: N = 64
@@ -88,18 +164,44 @@ void APP_loadProgram()
 //	_delay_ms(150);
 //	SFX_tone(FREQ_C4,150);
 	
-	/* Enable Master Updates */
-	APP_startMode_main();
+	/* Enable Master Updates (Resuming an Interrupted Trace) */
+	APP_startMode_resume();
 	sei();
 }
 
+void APP_service()
+{
+	/* Run Task Latched By Keypad */
+	KEY_service();
+	
+	/* Keep Retrace Read-Ahead Topped Up (Card Is Only Touched Here, Never From a Fix) */
+	APP_retrace_prefetch();
+	
+	/* Run Master Update Flagged By Timer 0 */
+	if(updateDue){
+		updateDue = 0;
+		APP_update_MASTER();
+	}
+}
+
+void APP_flagUpdate()
+{
+	/* Request Master Update From Main Loop */
+	updateDue = 1;
+}
+
 void APP_startMode_main()
 {
 	/* Start Main */
 	APP_setUpdateState(0);
 	KEY_setState(0);
+	APP_simplify_flush();
+	APP_journal_flush();
+	APP_close_visit();
+	APP_close_manifest();
 	LCD_generateScreen(MAINSCREEN);
 	settings.mode = NONE;
+	APP_governRate();
 	APP_setUpdateState(1);
 	KEY_setState(1);
 }
@@ -111,6 +213,7 @@ void APP_startMode_debug()
 	KEY_setState(0);
 	LCD_generateScreen(DEBUGSCREEN);
 	settings.mode = DEBUGGING;
+	APP_governRate();
 	APP_setUpdateState(1);
 	KEY_setState(1);
 }
@@ -123,116 +226,228 @@ void APP_startMode_trace()
 	/* Turn Keys OFF */
 	KEY_setState(0);
 	
-	/* Request Initial GPS Info */
-	if(!settings.isDGPSon) GPS_request_update();
-	
 	/* Generate Navigation Screen */
 	LCD_generateScreen(TRACESCREEN);
 	
-	/* Update Manifest */ 
-	APP_write_manifest(M_TRACE);
-	
 	/* Turn Keys ON */
 	KEY_setState(1);
 	
-	/* Wait Until GPS Parsing Yields Valid Data */
-	if(!settings.isDGPSon){
-		do{
-			while(SYS_GPS.IS_PROCESSING) ;
-			if(SYS_GPS.STATUS != 'A')		GPS_request_update();
-		} while(SYS_GPS.STATUS != 'A');	 
-		
-		/* Set Latitude and Longitude Past Values for Offset Calculation */
-		for(int i = 0; i < GPS_BYTES_ASCII_LATITUDE; i++)	SYS_GPS.LATITUDE_ASCII_LAST[i] = SYS_GPS.LATITUDE_ASCII[i];
-		for(int i = 0; i < GPS_BYTES_ASCII_LONGITUDE; i++)	SYS_GPS.LONGITUDE_ASCII_LAST[i] = SYS_GPS.LONGITUDE_ASCII[i];
-		for(int i = 0; i < GPS_BYTES_ASCII_UTC_TIME; i++)	SYS_GPS.UTC_TIME_ASCII_LAST[i] = SYS_GPS.UTC_TIME_ASCII[i];
-	}
+	/* Wait Until GPS Parsing Yields a Usable Fix */
+	if(!settings.isDGPSon) APP_wait_fix();
+	
+	/* Open Manifest Entry, Anchoring the Trace (Origin, Start Stamp) to That Fix */
+	APP_write_manifest(M_TRACE);
 	
 	/* Write Initial Router */
 	APP_write_router();
 	
 	/* Populate Navigation Screen */
+	APP_update_clock();
+	APP_update_trace();
+	
+	/* Set Mode To Tracing */
+	settings.mode = TRACING;
+	APP_governRate();
+	
+	/* Turn Updates ON */
+	APP_setUpdateState(1);
+}
+
+void APP_startMode_resume()
+{
+	/* Nothing Was Being Traced: Start Main */
+	if(trace.summary.magic != DAT_PAGE_MAGIC || trace.summary.closed){
+		APP_startMode_main();
+		return;
+	}
+	
+	/* Turn Updates and Keys OFF */
+	APP_setUpdateState(0);
+	KEY_setState(0);
+	
+	/* Generate Navigation Screen */
+	LCD_generateScreen(TRACESCREEN);
+	KEY_setState(1);
+	
+	/* Wait Until GPS Parsing Yields a Usable Fix (the Trace Keeps Its Origin) */
+	if(!settings.isDGPSon) APP_wait_fix();
+	
+	/* Commit the Recovered Visit and Reopen the Quadrant, Redrawing It */
+	APP_write_router();
+	APP_update_clock();
 	APP_update_trace();
 	
 	/* Set Mode To Tracing */
 	settings.mode = TRACING;
+	APP_governRate();
 	
 	/* Turn Updates ON */
 	APP_setUpdateState(1);
 }
 
+void APP_startMode_retrace()
+{
+	/* Lead Back Along the Last Trace to Its Origin */
+	APP_startMode_retracing(0);
+}
+
+void APP_startMode_follow()
+{
+	/* Follow the Last Trace From Its Origin */
+	APP_startMode_retracing(1);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //									   APP Private Functions									  //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 uint16_t APP_course2rot()
 {
-	return (atoi(SYS_GPS.COURSE_ASCII) + 90) % 360;
+	return (gps.COURSE / GPS_COURSE_SCALE + 90) % 360;
 }
 
 int16_t APP_lastSuper2rot()
 {
-	float tmp = ((float)(trace.pos.y - trace.sup.y))/((float)(trace.pos.x - trace.sup.x));
-	tmp = atan(tmp) * 180 / M_PI;
-	if(tmp < 0) tmp += 360;
-	return (int16_t)tmp;
+	/* Heading Since the Last Super Node, Or the Course While Still Standing On It */
+	if(trace.pos.x == trace.sup.x && trace.pos.y == trace.sup.y) return APP_course2rot();
+	return APP_target2rot(trace.pos.x - trace.sup.x,trace.pos.y - trace.sup.y);
 }
 
 void APP_update_MASTER ()
 {	 		
-	if(!SYS_GPS.IS_PROCESSING){
-		LCD_setIconState(GPSICON,0);
-		switch(settings.mode){
-			case NONE:
-			break;
-			
-			case DEBUGGING:
-			APP_update_debug();
-			break;
-			
-			case TRACING:
-			if(SYS_GPS.STATUS == 'D' || SYS_GPS.STATUS == 'A') APP_update_trace();
-			break;
-			
-			case RETRACING:
-			break;
-		}
+	/* Timer-Driven Updates Only Feed the Debug GPS; Live Fixes Arrive via APP_onFix */
+	if(!settings.isDGPSon) return;
+	
+	switch(settings.mode){
+		case NONE:
+		break;
 		
-		if(settings.isDGPSon) APP_DGPS_incTime();
-		else {
-			if(SYS_GPS.STATUS == 'A') LCD_setIconState(GPSICON,1);
-			GPS_request_update();
-		}
-	}	
+		case DEBUGGING:
+		APP_update_debug();
+		break;
+		
+		case TRACING:
+		APP_update_clock();
+		APP_trip_update();
+		APP_update_trace();
+		break;
+		
+		case RETRACING:
+		APP_update_clock();
+		APP_update_retrace();
+		break;
+	}
+	
+	APP_DGPS_incTime();
 }
 
-void APP_update_trace()
-{	
+void APP_onFix(const GPS_data * fix)
+{
+	/* Ignore Live Fixes While Updates Are Off or Debug GPS Is Driving */
+	if(!updatesOn || settings.isDGPSon) return;
+	gps = *fix;
+	
+	/* Update Screens On Every Fix */
+	LCD_setIconState(GPSICON,GPS_fix_usable(&gps));
+	switch(settings.mode){
+		case DEBUGGING:	APP_update_debug();	break;
+		case TRACING:	APP_update_clock();	if(GPS_fix_usable(&gps)) APP_trip_update();		break;
+		case RETRACING:	APP_update_clock();	if(GPS_fix_usable(&gps)) APP_update_retrace();	break;
+		default: ;
+	}
+	
+	/* Follow Ground Speed */
+	APP_governRate();
+}
+
+void APP_onFix_trace(const GPS_data * fix)
+{
+	/* Run Trace Writer Once Per TRACE_PERIOD On a Usable Fix */
+	if(!updatesOn || settings.isDGPSon || settings.mode != TRACING) return;
+	gps = *fix;
+	if(GPS_fix_usable(&gps)) APP_update_trace();
+}
+
+void APP_wait_fix()
+{
+	/* Copy the Fix Right After GPS_service Completes an Epoch, Never Between Its Sentences */
+	uint8_t epoch = GPS_snapshot(&gps);
+	for(;;){
+		GPS_service();
+		if(GPS_snapshot(&gps) == epoch) continue;
+		if(GPS_fix_usable(&gps)) return;
+		epoch = gps.EPOCH;
+	}
+}
+
+void APP_governRate()
+{
+	/* Pick Output Rate From Mode (and Ground Speed While Tracing) */
+	GPS_rate rate = GPS_get_rate();
+	GPS_rate want;
+	switch(settings.mode){
+		case TRACING:
+		case RETRACING:
+		want = rate;
+		if(gps.SPEED >= RATE_DRIVE_UP)									want = GPS_RATE_10HZ;
+		else if(gps.SPEED >= RATE_WALK_UP && want == GPS_RATE_1HZ)		want = GPS_RATE_5HZ;
+		if(want == GPS_RATE_10HZ && gps.SPEED < RATE_DRIVE_DOWN)		want = GPS_RATE_5HZ;
+		if(want == GPS_RATE_5HZ && gps.SPEED < RATE_WALK_DOWN)			want = GPS_RATE_1HZ;
+		break;
+		
+		case DEBUGGING:
+		want = GPS_RATE_5HZ;
+		break;
+		
+		default:
+		want = GPS_RATE_1HZ;
+	}
+	
+	/* Switch Rate, Keeping Trace Writer Period in Seconds */
+	if(want == rate) return;
+	rate = GPS_set_rate(want);
+	GPS_set_decimation(APP_onFix_trace,GPS_RATE_HZ(rate) * TRACE_PERIOD);
+}
+
+void APP_update_clock()
+{
 	/* If Time Has Changed */
-	if(SYS_GPS.UTC_TIME_ASCII_LAST != SYS_GPS.UTC_TIME_ASCII)
+	if(trace.lastTime != gps.UTC_TIME)
 	{
 		/* Update UTC Pane */
-		for(int i = 0; i < GPS_BYTES_ASCII_UTC_TIME; i++)	SYS_GPS.UTC_TIME_ASCII_LAST[i] = SYS_GPS.UTC_TIME_ASCII[i];
+		char str[GPS_ASCII_TIME];
+		trace.lastTime = gps.UTC_TIME;
 		LCD_setText(NAVSCREEN_UTC_TEXTX,NAVSCREEN_UTC_TEXTY,2,WHITE,NAVSCREEN_SCREENCOLOR);
-		LCD_println_str_len(SYS_GPS.UTC_TIME_ASCII,8);  
+		GPS_format_time(gps.UTC_TIME,str);	LCD_println_str_len(str,8);
 		pencil.size = 1;	pencil.fg = OLIVE;
-		LCD_print_str(SYS_GPS.UTC_DATE_ASCII);
+		GPS_format_date(gps.UTC_DATE,str);	LCD_print_str(str);
 	}
+}
 
+void APP_update_trace()
+{	
 	/* If Position Has Changed */
-	int latMinOff = atoi(SYS_GPS.LATITUDE_ASCII) - atoi(SYS_GPS.LATITUDE_ASCII_LAST);
-	int lonMinOff = atoi(SYS_GPS.LONGITUDE_ASCII) - atoi(SYS_GPS.LONGITUDE_ASCII_LAST); 
-	if(abs(latMinOff) >= NODESIZE*2 || abs(lonMinOff) >= NODESIZE*2)
+	int16_t x = APP_FIX2POS(gps.LONGITUDE - trace.originLon);
+	int16_t y = APP_FIX2POS(gps.LATITUDE - trace.originLat);
+	if(abs(y - trace.pos.y) >= NODESIZE*2 || abs(x - trace.pos.x) >= NODESIZE*2)
 	{
 		/* Update Position */
-		trace.pos.x += lonMinOff;	strcpy(SYS_GPS.LONGITUDE_ASCII_LAST,SYS_GPS.LONGITUDE_ASCII);
-		trace.pos.y += latMinOff;	strcpy(SYS_GPS.LATITUDE_ASCII_LAST,SYS_GPS.LATITUDE_ASCII);
+		trace.pos.x = x;
+		trace.pos.y = y;
 		
 		/* Check if New Quadrant is Entered */
-		if     (trace.pos.x - trace.ref.x > MAPXBOUND) { trace.quad.x++; trace.ref.x += NAVSCREEN_MAP_PANEW * D2PX; APP_write_router(); }
-		else if(trace.ref.x - trace.pos.x > MAPXBOUND) { trace.quad.x--; trace.ref.x -= NAVSCREEN_MAP_PANEW * D2PX; APP_write_router(); }
-		else if(trace.pos.y - trace.ref.y > MAPYBOUND) { trace.quad.y++; trace.ref.y += NAVSCREEN_MAP_PANEH * D2PX; APP_write_router(); }
-		else if(trace.ref.y - trace.pos.y > MAPYBOUND) { trace.quad.y--; trace.ref.y -= NAVSCREEN_MAP_PANEH * D2PX; APP_write_router(); }
+		if     (trace.pos.x - trace.ref.x > MAPXBOUND) { trace.quad.x++; APP_shift_frame( NAVSCREEN_MAP_PANEW * D2PX,0); APP_write_router(); }
+		else if(trace.ref.x - trace.pos.x > MAPXBOUND) { trace.quad.x--; APP_shift_frame(-NAVSCREEN_MAP_PANEW * D2PX,0); APP_write_router(); }
+		else if(trace.pos.y - trace.ref.y > MAPYBOUND) { trace.quad.y++; APP_shift_frame(0, NAVSCREEN_MAP_PANEH * D2PX); APP_write_router(); }
+		else if(trace.ref.y - trace.pos.y > MAPYBOUND) { trace.quad.y--; APP_shift_frame(0,-NAVSCREEN_MAP_PANEH * D2PX); APP_write_router(); }
+		
+		/* Pan the View Once the Position Strays MAPPANSTEP From Its Centre */
+		if(settings.isPanOn && (abs(trace.pos.x - trace.ref.x - trace.view.x) > MAPPANSTEP || abs(trace.pos.y - trace.ref.y - trace.view.y) > MAPPANSTEP))
+		{
+			trace.view.x = trace.pos.x - trace.ref.x;
+			trace.view.y = trace.pos.y - trace.ref.y;
+			APP_draw_view();
+		}
 		
 		/* Write New Node */
 		static uint8_t nodeCount = 0;	nodeCount++;
@@ -248,360 +463,2087 @@ void APP_update_trace()
 	}
 }
 
+void APP_trip_update()
+{
+	/* Grow the Trace's Bounding Box */
+	if(gps.LONGITUDE < trace.summary.lon0) trace.summary.lon0 = gps.LONGITUDE;
+	if(gps.LONGITUDE > trace.summary.lon1) trace.summary.lon1 = gps.LONGITUDE;
+	if(gps.LATITUDE  < trace.summary.lat0) trace.summary.lat0 = gps.LATITUDE;
+	if(gps.LATITUDE  > trace.summary.lat1) trace.summary.lat1 = gps.LATITUDE;
+	
+	/* Step From the Last Fix [0.01 s]; Its Time Isn't Counted If It Spans a Lost Fix (Or a Resume) */
+	uint32_t now = gps.UTC_TIME * 100 + gps.UTC_CENTI;
+	uint32_t dt = (now + GPS_SECONDS_PER_DAY * 100 - trace.tripTime) % (GPS_SECONDS_PER_DAY * 100);
+	int32_t dlon = gps.LONGITUDE - trace.tripLon;
+	int32_t dlat = gps.LATITUDE - trace.tripLat;
+	uint8_t stepped = trace.tripFix;
+	uint8_t timed = stepped && dt <= TRIP_GAP * 100;
+	if(timed && dt == 0) return;
+	trace.tripLon = gps.LONGITUDE;
+	trace.tripLat = gps.LATITUDE;
+	trace.tripTime = now;
+	trace.tripFix = 1;
+	if(!stepped) return;
+	
+	/* Standing Still: Time Only, Jitter Is No Distance (Whole Seconds Reach the Summary, Hundredths Carry) */
+	if(timed){
+		if(gps.SPEED < TRIP_MOVING){
+			dt += trace.tripStopped;
+			trace.summary.stopped += dt / 100;
+			trace.tripStopped = dt % 100;
+			return;
+		}
+		dt += trace.tripMoving;
+		trace.summary.moving += dt / 100;
+		trace.tripMoving = dt % 100;
+		if(gps.SPEED > trace.summary.maxSpeed) trace.summary.maxSpeed = gps.SPEED;
+	}
+	
+	/* Equirectangular Step (Straight Across a Gap): Longitude Shrinks By cos(Latitude), Interpolated in 1/256 deg */
+	uint32_t lat = labs(gps.LATITUDE);
+	uint16_t cosLat = MATH_cos_frac(lat / GPS_COORD_SCALE,(lat % GPS_COORD_SCALE) / 39063);
+	int32_t dx = (dlon >> 15) * (int32_t)cosLat + (((dlon & 0x7FFF) * (int32_t)cosLat) >> 15);	// Split so any step fits 32 bits
+	trace.summary.distance += APP_FIX2CM(MATH_hypot(dx,dlat));
+}
+
+void APP_shift_frame(int16_t dx, int16_t dy)
+{
+	/* Move the Origin With the Quadrant, so Positions Stay Small However Far the Trace Goes */
+	trace.originLon += APP_POS2FIX(dx);
+	trace.originLat += APP_POS2FIX(dy);
+	trace.pos.x -= dx;	trace.pos.y -= dy;
+	trace.sup.x -= dx;	trace.sup.y -= dy;
+	if(settings.isPanOn){ trace.view.x -= dx;	trace.view.y -= dy; }
+}
+
 void APP_update_debug()
 {
 	/* Set Text Parameters */
 	LCD_setText(DEBUGSCREEN_START_X,DEBUGSCREEN_START_Y,DEBUGSCREEN_TEXT_SIZE,DEBUGSCREEN_TEXT_COLOR,DEBUGSCREEN_SCREENCOLOR);
 	
 	/* Print All Parameters */
-	LCD_print_str_len (SYS_GPS.UTC_TIME_ASCII,8);		LCD_print_char('\n');
-	LCD_print_str (SYS_GPS.UTC_DATE_ASCII);		LCD_print_char('\n');
-	LCD_print_char(SYS_GPS.STATUS);				LCD_print_char('\n');
-	LCD_print_str (SYS_GPS.LATITUDE_ASCII);		LCD_print_char('\n');
-	LCD_print_str (SYS_GPS.LONGITUDE_ASCII);	LCD_print_char('\n');
-	LCD_print_str (SYS_GPS.SPEED_ASCII);		LCD_print_char('\n');
-	LCD_print_str (SYS_GPS.COURSE_ASCII);		LCD_print_char('\n');
+	char str[GPS_ASCII_DECIMAL];
+	GPS_format_time(gps.UTC_TIME,str);							LCD_print_str(str);	LCD_print_char('\n');
+	GPS_format_date(gps.UTC_DATE,str);							LCD_print_str(str);	LCD_print_char('\n');
+	LCD_print_char(gps.STATUS);														LCD_print_char('/');
+	utoa(gps.SATELLITES,str,10);								LCD_print_str(str);	LCD_print_char('/');
+	GPS_format_decimal(gps.HDOP,2,str);							LCD_print_str(str);	LCD_print_char('\n');
+	GPS_format_coord(gps.LATITUDE,'N','S',str);					LCD_print_str(str);	LCD_print_char('\n');
+	GPS_format_coord(gps.LONGITUDE,'E','W',str);				LCD_print_str(str);	LCD_print_char('\n');
+	GPS_format_decimal(gps.SPEED,2,str);						LCD_print_str(str);	LCD_print_char('\n');
+	GPS_format_decimal(gps.COURSE,2,str);						LCD_print_str(str);	LCD_print_char('\n');
+	
+	/* Print Sentence Counters */
+	utoa(GPS_STATS.good,str,10);									LCD_print_str(str);	LCD_print_char('\n');
+	utoa(GPS_STATS.bad,str,10);										LCD_print_str(str);	LCD_print_char('/');
+	utoa(GPS_RX.overruns + GPS_RX.hw_overruns,str,10);				LCD_print_str(str);	LCD_print_char('\n');
+}
+
+#ifdef DEBUG
+void APP_benchmark_math()
+{
+	/* Time the MATH Kernels, Then List Them Beside the Options: Fixed/Float [cycles per call] */
+	static const char name[MATH_BENCH_COUNT][7] PROGMEM = {"sin   ","cos   ","atan2 ","hypot "};
+	MathBench bench[MATH_BENCH_COUNT];
+	char str[6];
+	MATH_benchmark(bench);
+	LCD_setText(DEBUGSCREEN_BENCH_X,DEBUGSCREEN_OPTION_Y,1,DEBUGSCREEN_TEXT_COLOR,DEBUGSCREEN_SCREENCOLOR);
+	for(uint8_t k = 0; k < MATH_BENCH_COUNT; k++)
+	{
+		LCD_print_str_P(name[k]);
+		utoa(bench[k].fixed,str,10);							LCD_print_str(str);	LCD_print_char('/');
+		utoa(bench[k].real,str,10);								LCD_print_str(str);	LCD_print_str_P(PSTR("  \n"));
+	}
+}
+
+void APP_trips_today()
+{
+	/* Bisect for the First Entry Started Today (UTC), Then List Its Traces Under the Options: #eid start distance [m] */
+	ManifestEntry entry;
+	char str[GPS_ASCII_TIME];
+	if(!gps.UTC_DATE) return;											// No date yet
+	uint16_t eid = APP_manifest_find_time(APP_STAMP(gps.UTC_DATE,0) - 1) + 1;
+	LCD_setText(MAINSCREEN_OPTION_X,MAINSCREEN_TRIPS_Y,1,MAINSCREEN_TEXT_COLOR,MAINSCREEN_SCREENCOLOR);
+	for(uint8_t n = 0; eid <= settings.entryCount && n < MAINSCREEN_TRIPS_LINES; eid++)
+	{
+		if(APP_manifest_get(eid,&entry) || entry.type != M_TRACE) continue;
+		utoa(eid,str,10);										LCD_print_char('#');	LCD_print_str(str);
+		GPS_format_time(entry.t0 % GPS_SECONDS_PER_DAY,str);	LCD_print_char(' ');	LCD_print_str(str);
+		ultoa(entry.distance / 100,str,10);					LCD_print_char(' ');	LCD_print_str(str);	LCD_print_str_P(PSTR(" m\n"));
+		n++;
+	}
+}
+#endif
+
+void APP_print_fix()
+{
+	/* Print Current Fix as Decimal Degrees */
+	char str[GPS_ASCII_COORD];
+	GPS_format_coord(gps.LONGITUDE,'E','W',str);	LCD_print_str_P(PSTR("X:"));	LCD_print_str(str);
+	GPS_format_coord(gps.LATITUDE,'N','S',str);		LCD_print_str_P(PSTR("\nY:"));	LCD_print_str(str);
 }
 
 uint8_t APP_formatCard()
 {
-	/* Load All Data From EEPROM */
-//	EEPROM_recovery();
-		
-	/* Load 8-bit Signature From Card */
-//	LCD_setIconState(CARDICON,1);
-//	APP_disk_2_buff(DISK_SIGNTURE_SECTOR,)
-// LCD_setIconState(CARDICON,0);
-			
-	/* If Signatures Match, Load Previous Settings and Return 0 */
-//	if(buff[0] == NV_USER_PREFERENCES_0){
-//		settings.isDGPSon = ;				/* CHRIS PLEASE DO THIS CODE */
-//		settings.mode = ;					/* Change NV_USER_PREFERENCES_0 to
-//		settings.pos2px = ;					/* variable corrosponding to signiture */
-//		settings.posThres = ;				/* and load variables into corrsponding */
-//		settings.entryCount = ;				/* settings on the left */
-//		settings.liveSector = ;
-//		return 0;
-//	}
-	
-	/* Else, Run Default Settings, Write New Signatures, and Return 1 */ 
-//	else{
-		LCD_setIconState(CARDICON,1);
-		DISK_wipe(0,10);
-		DISK_wipe(256,10);
-		DISK_wipe(750,100);
-		DISK_wipe(1600,500);
+	/* If the Card Is Signed With This Layout, Pick Up Where Its Last Checkpoint Left Off (Else Rescan Its Manifest) and Return 0 */
+	LCD_setIconState(CARDICON,1);
+	if(!APP_mount()){
+		if(APP_checkpoint_recover() && APP_manifest_rescan())
+			settings.entryCount = MAN_BLOCKLEN * MAN_ENTRIES;	// Unreadable: refuse new entries rather than write over ones not read
 		LCD_setIconState(CARDICON,0);
-		settings.isDGPSon = 0;
-		settings.mode = NONE;
-		settings.entryCount = 0;
-		settings.liveSector = DAT_SECTOR;
-//		byte newSig = APP_genSig();					/* CHRISTOPHER HERE TOO */
-//		EEPROM_writeAll();							/* Please write a signiture generation */		
-//		buff[0] = newSig;							/* function and write all settings into EEPROM space */
-//		DISK_write(buff,1,DISK_SIGNTURE_SECTOR);	/* You don't need to change anything else here */
-		return 1;
-//	}		
+		return 0;
+	}
+	
+	/* Else, Run Default Settings */
+	settings.isDGPSon = 0;
+	settings.isPanOn = 0;
+	settings.mode = NONE;
+	settings.entryCount = 0;
+	settings.liveSector = DAT_SECTOR;
+	settings.liveCount = 0;
+	settings.freeSector = DAT_SECTOR + 1;
+	memset(&trace,0,sizeof(trace));
+	journalPrev = 0;
+	checkpointSeq = 0;
+	
+	/* Clear Old Checkpoints and Entries, Sign the Card, and Return 1 (Other Sectors Are Set Up As They Are Handed Out) */
+	DISK_wipe(CHK_SECTOR,CHK_BLOCKLEN);
+	DISK_wipe(MAN_SECTOR,1);
+	APP_checkpoint(1);
+	APP_sign_card();
+	LCD_setIconState(CARDICON,0);
+	return 1;
+}
+
+uint8_t APP_mount()
+{
+	/* Read Superblock: Signature, Layout Version and Geometry Must Match, and Its CRC Hold */
+	Superblock * sb = (Superblock *)disk.buff;
+	if(DISK_read(SIG_SECTOR)) return 1;
+	if(memcmp(sb->signature,SIG_SIGNATURE,sizeof(SIG_SIGNATURE)) || sb->version != SIG_VERSION
+		|| sb->sectorSize != DISK_SECTOR_SIZE || sb->manSector != MAN_SECTOR || sb->manBlocklen != MAN_BLOCKLEN
+		|| sb->manEntries != MAN_ENTRIES || sb->chkSector != CHK_SECTOR || sb->chkBlocklen != CHK_BLOCKLEN
+		|| sb->datSector != DAT_SECTOR || sb->crc != APP_crc16((const uint8_t *)disk.buff,SIG_CRC_SIZE)) return 1;
+	
+	/* Load Settings Kept With It (Where the Card Was Left Off Is Restored Next) */
+	settings.isDGPSon = 0;
+	settings.isPanOn = sb->isPanOn;
+	settings.mode = NONE;
+	return 0;
+}
+
+uint8_t APP_sign_card()
+{
+	/* Write Superblock Last, so a Format Cut Short Is Redone */
+	Superblock * sb = (Superblock *)disk.buff;
+	memset(disk.buff,0,DISK_SECTOR_SIZE);
+	memcpy(sb->signature,SIG_SIGNATURE,sizeof(SIG_SIGNATURE));
+	sb->version = SIG_VERSION;
+	sb->sectorSize = DISK_SECTOR_SIZE;
+	sb->manSector = MAN_SECTOR;
+	sb->manBlocklen = MAN_BLOCKLEN;
+	sb->manEntries = MAN_ENTRIES;
+	sb->chkSector = CHK_SECTOR;
+	sb->chkBlocklen = CHK_BLOCKLEN;
+	sb->datSector = DAT_SECTOR;
+	sb->isPanOn = settings.isPanOn;
+	sb->crc = APP_crc16((const uint8_t *)disk.buff,SIG_CRC_SIZE);
+	disk.buffIt = DISK_SECTOR_SIZE;
+	return DISK_write(SIG_SECTOR);
 }
 // ASSUMES TRACE HANDLER HAS CURRENT QUAD
 uint8_t APP_write_router()
 {
-	/* Read Router at Current Quadrant */
-	uint32_t quadSector =
-		trace.startSector 
-		+ (trace.quad.x + QUAD_COLCOUNT / 2)
-		+ (trace.quad.y + QUAD_ROWCOUNT / 2) * QUAD_COLCOUNT; 
-	if(DISK_read(quadSector)) return 1;
+	/* Close the Last Quadrant's Run and Visit, Committing Staged Nodes Before Reusing the Disk Buffer */
+	if(APP_simplify_flush()) return 1;
+	if(APP_journal_flush()) return 1;
+	if(APP_close_visit()) return 1;
+	if(APP_checkpoint(1)) return 1;
 	
-	/* Clear Map Pane */
-	LCD_drawRect_filled(NAVSCREEN_MAP_PANEX+1,NAVSCREEN_MAP_PANEY+1,NAVSCREEN_MAP_PANEW-2,NAVSCREEN_MAP_PANEH-2,NAVSCREEN_SCREENCOLOR);
+	/* Look Up (or Allocate) Router of Current Quadrant, and Read It */
+	RouterPage * router = (RouterPage *)disk.buff;
+	uint8_t created;
+	uint32_t quadSector = APP_find_router(trace.startSector,trace.quad,&created);
+	if(!quadSector) return 1;
+	if(!created && DISK_read(quadSector)) return 1;
 	
-	/* If Router Does NOT Exist */
-	if(disk.buffIt == 0)
-	{
-		/* Write New Router Into Bitmap */
-		DISK_loadBuff_int(D_ROUTER,DAT_TYPE_OFF);
-		DISK_loadBuff_int(settings.entryCount,DAT_EID_OFF);
-		DISK_loadBuff_int(settings.liveSector,DAT_ADDRN_OFF);
-		if(DISK_write(quadSector)) return 1;
-		
-		/* Write New Origin/Reference Into Bitmap */
-		APP_write_node((trace.quad.x == 0 && trace.quad.y == 0) ? D_ORIGINNODE : D_REFNODE);
+	/* Open Visit (Its Extent Reaches the Router Once the Quadrant Is Left) */
+	trace.visitRouter = quadSector;
+	trace.visitOpen = 1;
+	trace.visitNew = created || router->magic != DAT_PAGE_MAGIC;
+	trace.visit.addr = DAT_ADDR(settings.liveSector,settings.liveCount);
+	trace.visit.count = 0;
+	trace.visit.pages = 0;
+	trace.visit.x0 = trace.visit.y0 = INT8_MAX;
+	trace.visit.x1 = trace.visit.y1 = INT8_MIN;
+	checkpointDue = 1;
+	
+	/* Panning: the View Doesn't Jump With the Quadrant, Only Whether Its Tile Is Up to Date Matters */
+	tileBase = tileGen = trace.visitNew ? 0 : router->gen;
+	tilePendingCount = 0;
+	tileOn = 1;
+	if(settings.isPanOn)
+		tileOn = trace.visitNew || !router->gen || !APP_tile_stale(quadSector,router->gen);
+	
+	/* Else Blit Earlier Visits If Their Tile Is Up to Date (the Visit's Nodes Are Then Painted Into It) */
+	else if(!trace.visitNew && router->gen){
+		if(!APP_tile_blit(quadSector,router->gen,0,0)) return 0;
+		tileOn = 0;
 	}
 	
-	else
+	/* Else Clear Map Pane */
+	if(!settings.isPanOn)
+		LCD_drawRect_filled(NAVSCREEN_MAP_PANEX+1,NAVSCREEN_MAP_PANEY+1,NAVSCREEN_MAP_PANEW-2,NAVSCREEN_MAP_PANEH-2,NAVSCREEN_SCREENCOLOR);
+	
+	/* If Router Does NOT Exist, Start Quadrant With an Origin/Reference Node */
+	if(trace.visitNew)
+		return APP_write_node((trace.quad.x == 0 && trace.quad.y == 0) ? D_ORIGINNODE : D_REFNODE);
+	
+	/* Else Redraw Earlier Visits (Router Is Still in the Buffer Unless a Tile Header Replaced It) */
+	return settings.isPanOn ? 0 : APP_draw_router(quadSector,tileOn);
+}
+
+uint8_t APP_close_visit()
+{
+	/* Nothing to Commit */
+	if(!trace.visitOpen) return 0;
+	if(APP_index_flush()) return 1;
+	trace.visitOpen = 0;
+	if(trace.visit.count == 0 && !trace.visitNew) return 0;
+	
+	/* Append Extent to Router, Creating It On the Quadrant's First Visit */
+	RouterPage * router = (RouterPage *)disk.buff;
+	if(trace.visitNew)
 	{
-		/* Initialize Address/Node Iterators and Address Tracker */
-		uint16_t addrIt = DAT_ADDRN_OFF;
-		uint16_t nodeIt;
-		uint32_t currAddr = atoi(disk.buff + addrIt);
-		Vector2 readQuad;
-		
-		do {
-			/* Read First Node and Reset Node Iterator */
-			DISK_read(currAddr);
-			nodeIt = 0;
-			
-			do {
-				/* Draw Node */
-				switch(atoi(disk.buff+DAT_TYPE_OFF)){
-					case D_NORMALNODE:	LCD_drawCircle_filled(NAVSCREEN_MAP_X0 - atoi(disk.buff+DAT_X_OFF) / D2PX, NAVSCREEN_MAP_Y0 + atoi(disk.buff+DAT_Y_OFF) * D2PX, NODESIZE_S, NODECOLOR_NORMAL); break;
-					case D_SUPERNODE:	LCD_drawCircle_filled(NAVSCREEN_MAP_X0 - atoi(disk.buff+DAT_X_OFF) / D2PX, NAVSCREEN_MAP_Y0 + atoi(disk.buff+DAT_Y_OFF) * D2PX, NODESIZE, NODECOLOR_SUPER); break;
-					case D_ORIGINNODE:	LCD_drawCircle_filled(NAVSCREEN_MAP_X0, NAVSCREEN_MAP_Y0, NODESIZE, NODECOLOR_USER); break;
-					default: ;
-				}
-			
-				/* Read Next Node */
-				DISK_read(currAddr + ++nodeIt);
-			
-				/* While Node is Within Quadrant */
-				readQuad.x = atoi(disk.buff+DAT_QUADC_OFF);
-				readQuad.y = atoi(disk.buff+DAT_QUADR_OFF);
-			} while(disk.buffIt != 0 && (readQuad.x == trace.quad.x) && (readQuad.y == trace.quad.y));
-			
-			/* Read Next Address In Router */
-			addrIt += DAT_ADDRN_SIZE;
-			DISK_read(quadSector);
-			currAddr =  atoi(disk.buff + addrIt);
-		
-		/* While Address is Valid */		
-		} while(currAddr != 0);
-		
-		/* Append Live Sector to Router */
-		DISK_loadBuff_int(settings.liveSector,addrIt);
-		DISK_write(quadSector);
+		memset(disk.buff,0,DISK_SECTOR_SIZE);
+		router->magic = DAT_PAGE_MAGIC;
+		router->type = D_ROUTER;
+		router->eid = settings.entryCount;
 	}
+	else if(DISK_read(trace.visitRouter)) return 1;
+	router->gen += trace.visit.count;
+	if(trace.visit.count && router->count < DAT_ROUTER_EXTENTS)
+		router->ext[router->count++] = trace.visit;
+	disk.buffIt = DISK_SECTOR_SIZE;
+	if(DISK_write(trace.visitRouter)) return 1;
 	
-	return 0;
+	/* Paint the Visit's Last Nodes Into the Quadrant's Tile */
+	return APP_tile_merge();
 }
 
-// ASSUMES TRACE HANDLER HAS CURRENT REFERENCE AND POSITION
-uint8_t APP_write_node(DataType type)
+// PASS 'created' AS NULL TO LOOK UP WITHOUT ALLOCATING (RETURNS 0 IF QUADRANT WAS NEVER VISITED)
+uint32_t APP_find_router(uint32_t directory, Vector2 quad, uint8_t * created)
 {
-	/* Calculate Offset of Current Node */
-	Vector2 tmpOff = {trace.ref.x - trace.pos.x, trace.ref.y - trace.pos.y};
+	/* Walk the Directory Chain From Its Head */
+	DirectoryPage * dir = (DirectoryPage *)disk.buff;
+	uint32_t sector = directory;
+	if(created) *created = 0;
 	
-	/* Buffer First Generic Payload */
-	LCD_setIconState(CARDICON,1);
-	DISK_loadBuff_int(type,DAT_TYPE_OFF);				// [TYPE]
-	DISK_loadBuff_int(settings.entryCount,DAT_EID_OFF);	// [EID]
-
-	/* Buffer Node-Specific Payload Section */
-	switch(type)
+	while(1)
 	{
-		case D_NORMALNODE:		
-			/* Buffer Relative Offset */
-			DISK_loadBuff_int(tmpOff.x, DAT_X_OFF);
-			DISK_loadBuff_int(tmpOff.y, DAT_Y_OFF);
-		
-			/* Draw Node */
-			LCD_drawCircle_filled(
-				NAVSCREEN_MAP_X0 - tmpOff.x / D2PX, 
-				NAVSCREEN_MAP_Y0 + tmpOff.y / D2PX,
-				NODESIZE_S,
-				NODECOLOR_NORMAL);
-				
-			/* Update DIRA Pane */
-			LCD_setText(NAVSCREEN_DIRA_TEXTX,TFTHEIGHT-18,NAVSCREEN_DIRA_SIZE,NODECOLOR_NORMAL,NAVSCREEN_SCREENCOLOR);
-			LCD_print_str("X:");	LCD_print_str(SYS_GPS.LONGITUDE_ASCII+(SYS_GPS.LONGITUDE_ASCII[0]=='-'?1:0));	LCD_print_char(SYS_GPS.EW);
-			LCD_print_str("\nY:");	LCD_print_str(SYS_GPS.LATITUDE_ASCII+(SYS_GPS.LATITUDE_ASCII[0]=='-'?1:0));		LCD_print_char(SYS_GPS.NS);
-			LCD_drawArrow(NAVSCREEN_DIRA_TEXTX+40,NAVSCREEN_DIRA_TEXTY,APP_course2rot(),NODECOLOR_NORMAL,NAVSCREEN_SCREENCOLOR);
-			
-			/* Update DIRB Pane */
-			LCD_drawArrow(NAVSCREEN_DIRB_TEXTX+40,NAVSCREEN_DIRB_TEXTY,APP_lastSuper2rot(),NODECOLOR_SUPER,NAVSCREEN_SCREENCOLOR);
-			
-		break;
-		
-		case D_SUPERNODE:
-			/* Buffer Relative Offset */
-			DISK_loadBuff_int(tmpOff.x, DAT_X_OFF);
-			DISK_loadBuff_int(tmpOff.y, DAT_Y_OFF);
+		/* Probe From the Quadrant's Hash Slot Up to the First Empty One */
+		if(DISK_read(sector)) return 0;
+		uint8_t slot = DAT_DIR_HASH(quad);
+		while(dir->slot[slot].router)
+		{
+			if(dir->slot[slot].qx == quad.x && dir->slot[slot].qy == quad.y) return dir->slot[slot].router;
+			if(++slot == DAT_DIR_SLOTS) slot = 0;
+		}
 		
-			/* Draw Node */
-			LCD_drawCircle_filled(
-				NAVSCREEN_MAP_X0 - tmpOff.x / D2PX, 
-				NAVSCREEN_MAP_Y0 + tmpOff.y / D2PX,
-				NODESIZE,
-				NODECOLOR_SUPER);
-
-			/* Update DIRA Pane */
-			LCD_setText(NAVSCREEN_DIRA_TEXTX,TFTHEIGHT-18,NAVSCREEN_DIRA_SIZE,NODECOLOR_NORMAL,NAVSCREEN_SCREENCOLOR);
-			LCD_print_str("X:");	LCD_print_str(SYS_GPS.LONGITUDE_ASCII+(SYS_GPS.LONGITUDE_ASCII[0]=='-'?1:0));	LCD_print_char(SYS_GPS.EW);
-			LCD_print_str("\nY:");	LCD_print_str(SYS_GPS.LATITUDE_ASCII+(SYS_GPS.LATITUDE_ASCII[0]=='-'?1:0));		LCD_print_char(SYS_GPS.NS);
-			LCD_drawArrow(NAVSCREEN_DIRA_TEXTX+40,NAVSCREEN_DIRA_TEXTY,APP_course2rot(),NODECOLOR_NORMAL,NAVSCREEN_SCREENCOLOR);
-			
-			/* Update DIRB Pane */
-			LCD_setText(NAVSCREEN_DIRB_TEXTX,TFTHEIGHT-18,NAVSCREEN_DIRB_SIZE,NODECOLOR_SUPER,NAVSCREEN_SCREENCOLOR);
-			LCD_print_str("X:");	LCD_print_str(SYS_GPS.LONGITUDE_ASCII+(SYS_GPS.LONGITUDE_ASCII[0]=='-'?1:0));	LCD_print_char(SYS_GPS.EW);
-			LCD_print_str("\nY:");	LCD_print_str(SYS_GPS.LATITUDE_ASCII+(SYS_GPS.LATITUDE_ASCII[0]=='-'?1:0));		LCD_print_char(SYS_GPS.NS);
-			trace.sup.x = trace.pos.x;	trace.sup.y = trace.pos.y;
-			//LCD_drawArrow(NAVSCREEN_DIRB_TEXTX+40,NAVSCREEN_DIRB_TEXTY,APP_lastSuper2rot(),NODECOLOR_SUPER,NAVSCREEN_SCREENCOLOR);
-			LCD_drawRect_filled(NAVSCREEN_DIRB_TEXTX+40,NAVSCREEN_DIRB_TEXTY,29,29,NAVSCREEN_SCREENCOLOR);
+		/* Missing From a Sector With Room: New Quadrant, Allocate Its Router (Index, Tile, Tile Areas) Here */
+		if(dir->count < DAT_DIR_LOAD)
+		{
+			if(!created) return 0;
+			uint32_t router = settings.freeSector;
+			settings.freeSector += DAT_ROUTER_SECTORS;
+			dir->slot[slot].qx = quad.x;
+			dir->slot[slot].qy = quad.y;
+			dir->slot[slot].router = router;
+			dir->count++;
+			disk.buffIt = DISK_SECTOR_SIZE;
+			if(DISK_write(sector)) return 0;
 			
-		break;
-
-		case D_ORIGINNODE:
-			/* Buffer Absolute Position */
-			DISK_loadBuff_int(trace.pos.x, DAT_X_OFF);
-			DISK_loadBuff_int(trace.pos.y, DAT_Y_OFF);
-			
-			/* Draw Node */
-			LCD_drawCircle_filled(
-				NAVSCREEN_MAP_X0,
-				NAVSCREEN_MAP_Y0,
-				NODESIZE,
-				NODECOLOR_USER);
-				
-			/* Update DIRA Pane */
-			LCD_setText(NAVSCREEN_DIRA_TEXTX,TFTHEIGHT-18,NAVSCREEN_DIRA_SIZE,NODECOLOR_SUPER,NAVSCREEN_SCREENCOLOR);
-			LCD_print_str("X:");	LCD_print_str(SYS_GPS.LONGITUDE_ASCII+(SYS_GPS.LONGITUDE_ASCII[0]=='-'?1:0));	LCD_print_char(SYS_GPS.EW);
-			LCD_print_str("\nY:");	LCD_print_str(SYS_GPS.LATITUDE_ASCII+(SYS_GPS.LATITUDE_ASCII[0]=='-'?1:0));		LCD_print_char(SYS_GPS.NS);
-			LCD_drawArrow(NAVSCREEN_DIRA_TEXTX+40,NAVSCREEN_DIRA_TEXTY,APP_course2rot(),NODECOLOR_USER,NAVSCREEN_SCREENCOLOR);
-			
-			/* Update DIRB Pane */
-			LCD_setText(NAVSCREEN_DIRB_TEXTX,TFTHEIGHT-18,NAVSCREEN_DIRB_SIZE,NODECOLOR_SUPER,NAVSCREEN_SCREENCOLOR);
-			LCD_print_str("X:");	LCD_print_str(SYS_GPS.LONGITUDE_ASCII+(SYS_GPS.LONGITUDE_ASCII[0]=='-'?1:0));	LCD_print_char(SYS_GPS.EW);
-			LCD_print_str("\nY:");	LCD_print_str(SYS_GPS.LATITUDE_ASCII+(SYS_GPS.LATITUDE_ASCII[0]=='-'?1:0));		LCD_print_char(SYS_GPS.NS);
-			//LCD_drawArrow(NAVSCREEN_DIRB_TEXTX+40,NAVSCREEN_DIRB_TEXTY,APP_lastSuper2rot(),NODECOLOR_USER,NAVSCREEN_SCREENCOLOR);
-			LCD_drawRect_filled(NAVSCREEN_DIRB_TEXTX+40,NAVSCREEN_DIRB_TEXTY,29,29,NAVSCREEN_SCREENCOLOR);
-		break;
-		
-		case D_REFNODE:
-			/* Buffer Absolute Position */
-			DISK_loadBuff_int(trace.pos.x, DAT_X_OFF);
-			DISK_loadBuff_int(trace.pos.y, DAT_Y_OFF);
-		break;
+			/* Write Empty Index and Blank Tile (Router Itself Is Written When the Visit Closes) */
+			IndexPage * index = (IndexPage *)disk.buff;
+			memset(disk.buff,0,DISK_SECTOR_SIZE);
+			index->magic = DAT_PAGE_MAGIC;
+			index->type = D_INDEX;
+			disk.buffIt = DISK_SECTOR_SIZE;
+			if(DISK_write(router + 1)) return 0;
+			memset(disk.buff,0,DISK_SECTOR_SIZE);
+			disk.buffIt = DISK_SECTOR_SIZE;
+			if(DISK_write(router + 2)) return 0;
+			*created = 1;
+			return router;
+		}
 		
-		default: ;		
+		/* Sector Full: Follow the Chain, Extending It If This Is the Last Sector */
+		uint32_t next = dir->next;
+		if(!next)
+		{
+			if(!created) return 0;
+			next = settings.freeSector++;
+			dir->next = next;
+			disk.buffIt = DISK_SECTOR_SIZE;
+			if(DISK_write(sector)) return 0;
+			if(APP_create_directory(next)) return 0;
+		}
+		sector = next;
 	}
-	
-	/* Buffer Last Generic Payload */
-	DISK_loadBuff_str(SYS_GPS.UTC_TIME_ASCII,DAT_TIME_OFF);	// [TIME]
-	DISK_loadBuff_str(SYS_GPS.UTC_DATE_ASCII,DAT_DATE_OFF);	// [DATE]
-	DISK_loadBuff_int(trace.quad.x,DAT_QUADC_OFF);			// [QUAD COLUMN]
-	DISK_loadBuff_int(trace.quad.y,DAT_QUADR_OFF);			// [QUAD ROW]
-	
-	/* Append Node to Database */
-	if(DISK_write(settings.liveSector++))	return 1; 
-	LCD_setIconState(CARDICON,0);			return 0;
 }
 
-uint8_t APP_write_manifest(DataType type)
+uint8_t APP_create_directory(uint32_t sector)
 {
-	/* If 'type' is M_TRACE */
-	if(type == M_TRACE)
+	/* Write Empty Directory Sector */
+	DirectoryPage * dir = (DirectoryPage *)disk.buff;
+	memset(disk.buff,0,DISK_SECTOR_SIZE);
+	dir->magic = DAT_PAGE_MAGIC;
+	dir->type = D_DIRECTORY;
+	disk.buffIt = DISK_SECTOR_SIZE;
+	return DISK_write(sector);
+}
+
+uint8_t APP_draw_router(uint32_t quadSector, uint8_t resident)
+{
+	/* Redraw the Router's Visits, Copying Extents Out of It a Batch at a Time */
+	RouterPage * router = (RouterPage *)disk.buff;
+	RouterExtent ext[DAT_REDRAW_BATCH];
+	if(!resident && DISK_read(quadSector)) return 1;
+	uint16_t extCount = router->count;
+	for(uint16_t extIt = 0; extIt < extCount; extIt += DAT_REDRAW_BATCH)
 	{
-		/* Update Trace Handler */
-		trace.startSector = settings.liveSector;				// Save bitmap start address
-		settings.liveSector += QUAD_COLCOUNT * QUAD_ROWCOUNT;	// Shift live sector past bitmap
-		trace.quad.x = 0;										// Set starting quadrant
-		trace.quad.y = 0;										// ...
-		trace.pos.x = atoi(SYS_GPS.LONGITUDE_ASCII);			// Set starting position
-		trace.pos.y = atoi(SYS_GPS.LATITUDE_ASCII);				// ...
-		trace.sup.x = trace.pos.x;								// Set super position
-		trace.sup.y = trace.pos.y;								// ...
-		trace.ref.x = trace.pos.x;								// Set reference position
-		trace.ref.y = trace.pos.y;								// ...
+		uint8_t n = (extCount - extIt < DAT_REDRAW_BATCH) ? extCount - extIt : DAT_REDRAW_BATCH;
+		if(extIt && DISK_read(quadSector)) return 1;
+		memcpy(ext,router->ext + extIt,n * sizeof(RouterExtent));
+		for(uint8_t i = 0; i < n; i++)
+			if(APP_draw_extent(&ext[i])) return 1;
 	}
-		
-	/* Write Marker Into Manifest */							// ***
-	LCD_setIconState(CARDICON,1);								// ICON ON
-	DISK_loadBuff_int(type,MAN_TYPE_OFF);						// [ENTRY TYPE]
-	DISK_loadBuff_int(settings.liveSector,MAN_START_OFF);		// [START SECTOR]
-	if(DISK_write(++settings.entryCount)) return 1;				// [..to Manifest]
-	LCD_setIconState(CARDICON,0); return 0;						// ICON OFF
+	return 0;
 }
 
-////////////////////////////////////////////////////////////////////////////////////////////////////
-//										  Debug Functions										  //
-////////////////////////////////////////////////////////////////////////////////////////////////////
-
-void APP_DGPS_setState(uint8_t state)
+uint8_t APP_draw_extent(const RouterExtent * ext)
 {
-	if(state == 1 && !settings.isDGPSon)
+	/* Start at the Visit's First Record */
+	NodePage * page = (NodePage *)disk.buff;
+	uint16_t pages = ext->pages;
+	uint8_t skip = DAT_ADDR_INDEX(ext->addr);
+	uint16_t left = ext->count;
+	uint8_t nodeIt = 0;
+	const uint8_t * src = page->body;
+	NodeRecord node;
+	if(left == 0) return 0;
+	if(DISK_read(DAT_ADDR_SECTOR(ext->addr))) return 1;
+	
+	/* Decode Exactly 'count' Records, Following the Extent's Pages Down the Chain */
+	while(left)
 	{
-		/* Set All Characters To NULL By Default */
-		for(int i = 0; i < sizeof(SYS_GPS); i++) *((char*)(&SYS_GPS)+i) = 0;
-		
-		/* Set Default Strings */
-		SYS_GPS.STATUS = 'D';
-		strcpy(SYS_GPS.UTC_TIME_ASCII,"00:00:00");	strcpy(SYS_GPS.UTC_TIME_ASCII_LAST,"00:00:00");
-		strcpy(SYS_GPS.UTC_DATE_ASCII,"00/00/00");
-		strcpy(SYS_GPS.LATITUDE_ASCII,"0");		strcpy(SYS_GPS.LATITUDE_ASCII_LAST,"0");
-		strcpy(SYS_GPS.LONGITUDE_ASCII,"0");	strcpy(SYS_GPS.LONGITUDE_ASCII_LAST,"0");
-		strcpy(SYS_GPS.SPEED_ASCII,"0");
-		strcpy(SYS_GPS.COURSE_ASCII,"0");
-		SYS_GPS.NS = 'N';
-		SYS_GPS.EW = 'E';
-		
-		/* Enable DGPS */
-		settings.isDGPSon = 1;
+		if(nodeIt >= page->count){
+			if(--pages == 0 || !page->next) break;
+			if(DISK_read(page->next)) return 1;
+			src = page->body;
+			nodeIt = 0;
+			skip = 0;
+			continue;
+		}
+		src = APP_decode_node(src,&node);
+		if(nodeIt++ < skip) continue;
+		APP_draw_node(&node);
+		left--;
 	}
-	
-	/* Else If State = 0, Disable DGPS */
-	else if(state == 0)	settings.isDGPSon = 0;
+	return 0;
 }
 
-void APP_DGPS_setTime(uint8_t h, uint8_t m, uint8_t s)
+void APP_draw_node(const NodeRecord * node)
 {
-	/* Save Time */
-//	strcpy(SYS_GPS.UTC_TIME_ASCII_LAST,SYS_GPS.UTC_TIME_ASCII);
+	/* Place Stored Node In the Map Pane (Shifted While Drawing the View) */
+	int16_t x = NAVSCREEN_MAP_X0 + drawShift.x;
+	int16_t y = NAVSCREEN_MAP_Y0 + drawShift.y;
+	uint8_t r = NODESIZE;
+	Color color;
+	switch(node->type){
+		case D_NORMALNODE:	x -= node->x / D2PX;	y += node->y * D2PX;	r = NODESIZE_S;	color = NODECOLOR_NORMAL;	break;
+		case D_SUPERNODE:	x -= node->x / D2PX;	y += node->y * D2PX;					color = NODECOLOR_SUPER;	break;
+		case D_ORIGINNODE:															color = NODECOLOR_USER;		break;
+		default: return;
+	}
 	
-	/* Set Time */
-	itoa(h, SYS_GPS.UTC_TIME_ASCII,     10);
-	itoa(m, SYS_GPS.UTC_TIME_ASCII + 3, 10);
-	itoa(s, SYS_GPS.UTC_TIME_ASCII + 6, 10);
+	/* Draw It Unless It Lies Outside the Pane */
+	if(x < NAVSCREEN_MAP_PANEX || x > NAVSCREEN_MAP_PANEX + NAVSCREEN_MAP_PANEW) return;
+	if(y < NAVSCREEN_MAP_PANEY || y > NAVSCREEN_MAP_PANEY + NAVSCREEN_MAP_PANEH) return;
+	LCD_drawCircle_filled(x,y,r,color);
+}
+
+/***************************************************************************************************
+	Map Tiles
+		A quadrant's tile (TilePage) follows its visits: the nodes a visit stores there are held
+		in 'tilePending' and painted into the tile DAT_TILE_NODES at a time, and when the visit
+		closes. Merging streams the old tile's runs off the card (DISK_stream_open), one pane row
+		at a time, paints the pending nodes reaching the row as APP_draw_node would draw them,
+		and encodes the row into new runs assembled in the disk buffer. No node pages are read,
+		and each old sector is clocked through once; only writing out a full sector of new runs
+		ends its read early, which then picks up again at the same byte.
+		The new runs go to whichever of the quadrant's two tile areas the old ones aren't in,
+		and the header is switched over last, so the tile takes no more sectors as it's merged
+		and a merge cut short leaves the old tile whole. A tile busier than an area is dropped.
+		Entering the quadrant again blits the tile through a single LCD window instead of
+		clearing the pane and redrawing each node pixel by pixel. A tile that falls behind its
+		router (it wasn't current when the visit opened) stays out of date, and the quadrant is
+		redrawn from its nodes.
+		
+***************************************************************************************************/
+// ASSUMES DISK BUFFER IS FREE (JOURNAL FLUSHED)
+uint8_t APP_tile_merge()
+{
+	/* Tile Fell Behind: Leave It */
+	TilePage * tile = (TilePage *)disk.buff;
+	uint8_t n = tilePendingCount;
+	uint16_t gen = tileBase + trace.visit.count;
+	tilePendingCount = 0;
+	if(!tileOn || gen == tileGen) return 0;
+	
+	/* Merge Into the Tile Written Last (Blank Pane Before the First Node) */
+	uint32_t data = 0;
+	uint16_t bytes = 0;
+	if(tileGen){
+		if(APP_tile_stale(trace.visitRouter,tileGen)){
+			tileOn = 0;
+			return 0;
+		}
+		data = tile->data;
+		bytes = tile->bytes;
+	}
+	tileGen = gen;
+	
+	/* Records That Draw Nothing Only Move the Generation On */
+	if(n == 0) return APP_tile_header(trace.visitRouter + 2,gen,data,bytes);
+	
+	/* Runs Go to the Tile Area the Old Runs Aren't In */
+	uint16_t inAt = 0;				// Old runs read
+	uint8_t inColor = 0;			// Old run being decoded
+	uint16_t inLeft = 0;			// ...and its pixels left
+	uint8_t color = 0, run = 0;		// New run being encoded
+	tileData = DAT_TILE_AREA(trace.visitRouter,data == DAT_TILE_AREA(trace.visitRouter,0));
+	tileBytes = 0;
+	
+	for(int16_t row = 0; row < DAT_TILE_H; row++)
+	{
+		/* Decode the Old Row (Blank Past the Last Run) */
+		for(uint8_t x = 0; x < DAT_TILE_W; )
+		{
+			if(inLeft == 0 && inAt < bytes){
+				if(!disk.streamLeft && DISK_stream_open(data + inAt / DISK_SECTOR_SIZE,inAt % DISK_SECTOR_SIZE)) return 1;
+				uint8_t in = DISK_stream_byte();
+				inColor = in >> 6;
+				inLeft = (in & 0x3F) + 1;
+				inAt++;
+			}
+			else if(inLeft == 0){
+				inColor = 0;
+				inLeft = DAT_TILE_W;
+			}
+			for(; inLeft && x < DAT_TILE_W; inLeft--, x++){
+				uint8_t shift = (x & 3) * 2;
+				tileRow[x >> 2] = (tileRow[x >> 2] & ~(3 << shift)) | (inColor << shift);
+			}
+		}
+		
+		/* Paint Pending Nodes Over It, In the Order They Were Stored */
+		for(uint8_t i = 0; i < n; i++) APP_tile_paint(&shared.tilePending[i],row);
+		
+		/* Encode Row (the Last Run Stays Open Into the Next Row) */
+		for(uint8_t x = 0; x < DAT_TILE_W; x++)
+		{
+			uint8_t px = (tileRow[x >> 2] >> ((x & 3) * 2)) & 3;
+			if(run && (px != color || run == DAT_TILE_RUN)){
+				if(APP_tile_put((color << 6) | (run - 1))) return 1;
+				run = 0;
+			}
+			color = px;
+			run++;
+		}
+	}
+	if(APP_tile_put((color << 6) | (run - 1))) return 1;
+	DISK_stream_close();
+	
+	/* Too Busy for Its Area: the Header Keeps the Old Tile, Now Out of Date (the Quadrant Is Redrawn From Its Nodes) */
+	if(tileBytes > DAT_TILE_BYTES){
+		tileOn = 0;
+		return 0;
+	}
+	if(tileBytes % DISK_SECTOR_SIZE){
+		disk.buffIt = DISK_SECTOR_SIZE;
+		if(DISK_write(tileData + tileBytes / DISK_SECTOR_SIZE)) return 1;
+	}
+	
+	/* Point the Header At the New Runs */
+	return APP_tile_header(trace.visitRouter + 2,gen,tileData,tileBytes);
+}
+
+uint8_t APP_tile_header(uint32_t sector, uint16_t gen, uint32_t data, uint16_t bytes)
+{
+	/* Write Tile Header */
+	TilePage * tile = (TilePage *)disk.buff;
+	memset(disk.buff,0,DISK_SECTOR_SIZE);
+	tile->magic = DAT_PAGE_MAGIC;
+	tile->type = D_TILE;
+	tile->gen = gen;
+	tile->data = data;
+	tile->bytes = bytes;
+	tile->palette[0] = NAVSCREEN_SCREENCOLOR;
+	tile->palette[1] = NODECOLOR_NORMAL;
+	tile->palette[2] = NODECOLOR_SUPER;
+	tile->palette[3] = NODECOLOR_USER;
+	disk.buffIt = DISK_SECTOR_SIZE;
+	return DISK_write(sector);
+}
+
+uint8_t APP_tile_put(uint8_t run)
+{
+	/* Append Run to the Sector Being Assembled, Writing It Out Once Full (Runs Past the Area Are Only Counted) */
+	uint16_t at = tileBytes++;
+	if(at >= DAT_TILE_BYTES) return 0;
+	disk.buff[at % DISK_SECTOR_SIZE] = run;
+	if(tileBytes % DISK_SECTOR_SIZE) return 0;
+	disk.buffIt = DISK_SECTOR_SIZE;
+	return DISK_write(tileData + at / DISK_SECTOR_SIZE);
+}
+
+void APP_tile_paint(const TileNode * node, int16_t row)
+{
+	/* Place, Size and Palette Color as APP_draw_node Draws It */
+	int16_t cx, cy;
+	int8_t r;
+	uint8_t pal;
+	switch(node->type){
+		case D_NORMALNODE:	cx = NAVSCREEN_MAP_X0 - node->x / D2PX;	cy = NAVSCREEN_MAP_Y0 + node->y * D2PX;	r = NODESIZE_S;	pal = 1;	break;
+		case D_SUPERNODE:	cx = NAVSCREEN_MAP_X0 - node->x / D2PX;	cy = NAVSCREEN_MAP_Y0 + node->y * D2PX;	r = NODESIZE;	pal = 2;	break;
+		case D_ORIGINNODE:	cx = NAVSCREEN_MAP_X0;					cy = NAVSCREEN_MAP_Y0;					r = NODESIZE;	pal = 3;	break;
+		default: return;
+	}
+	cx -= NAVSCREEN_MAP_PANEX + 1;
+	cy -= NAVSCREEN_MAP_PANEY + 1;
+	
+	/* Fill the Circle's Span On This Row as LCD_drawCircle_filled Does */
+	int16_t dy = row - cy;
+	if(dy < -r || dy > r) return;
+	for(int8_t dx = -r; dx <= r; dx++)
+	{
+		int16_t col = cx + dx;
+		if(col < 0 || col >= DAT_TILE_W) continue;
+		if(r == 1 ? (dx || dy) : dx * dx + dy * dy > r * r + r) continue;
+		uint8_t shift = (col & 3) * 2;
+		tileRow[col >> 2] = (tileRow[col >> 2] & ~(3 << shift)) | (pal << shift);
+	}
+}
+
+uint8_t APP_tile_stale(uint32_t quadSector, uint16_t gen)
+{
+	/* Read Tile Header: Out of Date Unless It Rendered 'gen' */
+	TilePage * tile = (TilePage *)disk.buff;
+	if(DISK_read(quadSector + 2)) return 1;
+	return tile->magic != DAT_PAGE_MAGIC || tile->type != D_TILE || tile->gen != gen;
+}
+
+uint8_t APP_tile_blit(uint32_t quadSector, uint16_t gen, int16_t sx, int16_t sy)
+{
+	/* Only an Up to Date Tile Will Do */
+	TilePage * tile = (TilePage *)disk.buff;
+	if(APP_tile_stale(quadSector,gen)) return 1;
+	Color palette[4];
+	memcpy(palette,tile->palette,sizeof(palette));
+	uint32_t data = tile->data;
+	uint16_t bytes = tile->bytes;
+	
+	/* Part of the Tile Left Inside the Pane Once Shifted By (sx,sy) */
+	int16_t x0 = (sx < 0) ? -sx : 0;
+	int16_t y0 = (sy < 0) ? -sy : 0;
+	int16_t x1 = (sx > 0) ? DAT_TILE_W - sx : DAT_TILE_W;
+	int16_t y1 = (sy > 0) ? DAT_TILE_H - sy : DAT_TILE_H;
+	if(x0 >= x1 || y0 >= y1) return 0;
+	
+	/* Blank Pane Has No Runs */
+	if(bytes == 0){
+		LCD_drawRect_filled(NAVSCREEN_MAP_PANEX+1+sx+x0,NAVSCREEN_MAP_PANEY+1+sy+y0,x1-x0,y1-y0,palette[0]);
+		return 0;
+	}
+	
+	/* Stream Runs Into a Window On That Part, Reading a Sector Between Runs (LCD and Card Share the Bus) */
+	LCD_openWindow(NAVSCREEN_MAP_PANEX+1+sx+x0,NAVSCREEN_MAP_PANEY+1+sy+y0,x1-x0,y1-y0);
+	int16_t x = 0, y = 0;
+	for(uint16_t i = 0; i < bytes && y < y1; i++)
+	{
+		if(i % DISK_SECTOR_SIZE == 0 && DISK_read(data + i / DISK_SECTOR_SIZE)) return 1;
+		uint8_t run = disk.buff[i % DISK_SECTOR_SIZE];
+		uint8_t len = (run & 0x3F) + 1;
+		
+		/* Split the Run Into Rows, Pushing What Falls In the Window */
+		while(len)
+		{
+			uint8_t n = (len < DAT_TILE_W - x) ? len : DAT_TILE_W - x;
+			int16_t a = (x > x0) ? x : x0;
+			int16_t b = (x + n < x1) ? x + n : x1;
+			if(y >= y0 && y < y1 && a < b) LCD_pushRun(palette[run >> 6],b - a);
+			len -= n;
+			x += n;
+			if(x == DAT_TILE_W){ x = 0; y++; }
+		}
+	}
+	return 0;
+}
+
+/***************************************************************************************************
+	Map Panning
+		With 'isPanOn' the map pane is centred on 'trace.view' instead of the quadrant reference,
+		and is centred on the position again once it strays MAPPANSTEP from the view's centre;
+		entering another quadrant no longer redraws the pane. The view reaches up to four
+		quadrants. Each is blitted from its tile, shifted and clipped to the pane, or redrawn from
+		its visits if its tile is out of date; the current quadrant's nodes that haven't reached
+		its tile yet are drawn from 'tilePending'. The ILI9341 can only scroll whole columns of
+		the screen (the panes under the map would scroll along) and can't be read back, so each
+		pan redraws the pane, but from tiles its cost doesn't grow with the nodes shown.
+		
+***************************************************************************************************/
+void APP_toggle_pan()
+{
+	/* Flip Setting and Sign It Onto the Card (Mounting Loads It), Centring the View On the Position While Tracing */
+	settings.isPanOn = !settings.isPanOn;
+	if(!APP_journal_flush()) APP_sign_card();
+	trace.view.x = trace.view.y = 0;
+	if(settings.mode != TRACING) return;
+	if(settings.isPanOn){
+		trace.view.x = trace.pos.x - trace.ref.x;
+		trace.view.y = trace.pos.y - trace.ref.y;
+	}
+	APP_draw_view();
+}
+
+// FLUSHES THE JOURNAL (USES DISK BUFFER)
+uint8_t APP_draw_view()
+{
+	/* Quadrants the View Reaches: the Current One and Its Neighbours Toward the View's Centre */
+	int8_t sx = (trace.view.x > 0) - (trace.view.x < 0);
+	int8_t sy = (trace.view.y > 0) - (trace.view.y < 0);
+	uint8_t fail = APP_journal_flush();
+	for(uint8_t i = 0; i < 2 && !fail; i++)
+		for(uint8_t j = 0; j < 2 && !fail; j++)
+		{
+			if((i && !sx) || (j && !sy)) continue;
+			Vector2 quad = {trace.quad.x + i * sx, trace.quad.y + j * sy};
+			drawShift.x = (i * sx * NAVSCREEN_MAP_PANEW - trace.view.x) / D2PX;
+			drawShift.y = (trace.view.y - j * sy * NAVSCREEN_MAP_PANEH) * D2PX;
+			fail = APP_view_quadrant(quad);
+		}
+	drawShift.x = drawShift.y = 0;
+	return fail;
+}
+
+uint8_t APP_view_quadrant(Vector2 quad)
+{
+	/* Quadrant's Pane As Placed In the View */
+	RouterPage * router = (RouterPage *)disk.buff;
+	int16_t x = NAVSCREEN_MAP_PANEX + drawShift.x;
+	int16_t y = NAVSCREEN_MAP_PANEY + drawShift.y;
+	uint8_t current = trace.visitOpen && quad.x == trace.quad.x && quad.y == trace.quad.y;
+	uint32_t quadSector = current ? trace.visitRouter : APP_find_router(trace.startSector,quad,NULL);
+	uint16_t gen = tileGen;
+	if(!current){
+		if(!quadSector){
+			APP_view_clear(x,y,NAVSCREEN_MAP_PANEW,NAVSCREEN_MAP_PANEH);
+			return 0;
+		}
+		if(DISK_read(quadSector)) return 1;
+		gen = (router->magic == DAT_PAGE_MAGIC) ? router->gen : 0;
+	}
+	
+	/* Blit Its Tile (Blank Before Its First Node), Clearing the Border Around It */
+	if(current ? tileOn : gen != 0)
+	{
+		if(gen == 0) APP_view_clear(x,y,NAVSCREEN_MAP_PANEW,NAVSCREEN_MAP_PANEH);
+		else if(APP_tile_blit(quadSector,gen,drawShift.x,drawShift.y)){
+			if(current) tileOn = 0;
+			gen = 0;
+		}
+		if(current ? tileOn : gen != 0)
+		{
+			APP_view_clear(x,y,NAVSCREEN_MAP_PANEW,1);
+			APP_view_clear(x,y + NAVSCREEN_MAP_PANEH - 1,NAVSCREEN_MAP_PANEW,1);
+			APP_view_clear(x,y,1,NAVSCREEN_MAP_PANEH);
+			APP_view_clear(x + NAVSCREEN_MAP_PANEW - 1,y,1,NAVSCREEN_MAP_PANEH);
+			for(uint8_t i = 0; current && i < tilePendingCount; i++)
+			{
+				NodeRecord node;
+				node.x = shared.tilePending[i].x;
+				node.y = shared.tilePending[i].y;
+				node.type = shared.tilePending[i].type;
+				APP_draw_node(&node);
+			}
+			return 0;
+		}
+	}
+	
+	/* Else Redraw Its Visits (and the Open One's Nodes So Far) */
+	APP_view_clear(x,y,NAVSCREEN_MAP_PANEW,NAVSCREEN_MAP_PANEH);
+	if(!(current && trace.visitNew) && APP_draw_router(quadSector,0)) return 1;
+	return current ? APP_draw_extent(&trace.visit) : 0;
+}
+
+void APP_view_clear(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+	/* Clear Rectangle, Clipped to the Pane Inside Its Border */
+	int16_t x1 = x + w;
+	int16_t y1 = y + h;
+	if(x < NAVSCREEN_MAP_PANEX + 1) x = NAVSCREEN_MAP_PANEX + 1;
+	if(y < NAVSCREEN_MAP_PANEY + 1) y = NAVSCREEN_MAP_PANEY + 1;
+	if(x1 > NAVSCREEN_MAP_PANEX + NAVSCREEN_MAP_PANEW - 1) x1 = NAVSCREEN_MAP_PANEX + NAVSCREEN_MAP_PANEW - 1;
+	if(y1 > NAVSCREEN_MAP_PANEY + NAVSCREEN_MAP_PANEH - 1) y1 = NAVSCREEN_MAP_PANEY + NAVSCREEN_MAP_PANEH - 1;
+	if(x < x1 && y < y1) LCD_drawRect_filled(x,y,x1 - x,y1 - y,NAVSCREEN_SCREENCOLOR);
+}
+
+/***************************************************************************************************
+	Node Stream Codec
+		Varints hold 7 bits per byte, least significant first, with bit 7 set on every byte but the
+		last. Signed values are zigzag mapped first (0,-1,1,-2.. -> 0,1,2,3..), so the small steps
+		between consecutive nodes take a single byte.
+		
+***************************************************************************************************/
+#define APP_ZIGZAG(v)		(((uint32_t)(v) << 1) ^ (uint32_t)((int32_t)(v) >> 31))
+#define APP_UNZIGZAG(u)		((int32_t)((u) >> 1) ^ -(int32_t)((u) & 1))
+
+uint8_t * APP_put_varint(uint8_t * dst, uint32_t val)
+{
+	while(val >= 0x80){
+		*dst++ = (uint8_t)val | 0x80;
+		val >>= 7;
+	}
+	*dst++ = (uint8_t)val;
+	return dst;
+}
+
+const uint8_t * APP_get_varint(const uint8_t * src, uint32_t * val)
+{
+	uint32_t res = 0;
+	uint8_t shift = 0;
+	uint8_t data;
+	do{
+		data = *src++;
+		res |= (uint32_t)(data & 0x7F) << shift;
+		shift += 7;
+	} while((data & 0x80) && shift < 35);
+	*val = res;
+	return src;
+}
+
+uint8_t * APP_encode_node(uint8_t * dst, const NodeRecord * node, uint8_t key)
+{
+	/* Key: Whole Node */
+	if(key)
+	{
+		*dst++ = node->type | DAT_TAG_KEY;
+		dst = APP_put_varint(dst,APP_ZIGZAG(node->quad.x));
+		dst = APP_put_varint(dst,APP_ZIGZAG(node->quad.y));
+		dst = APP_put_varint(dst,APP_ZIGZAG(node->x));
+		dst = APP_put_varint(dst,APP_ZIGZAG(node->y));
+		return APP_put_varint(dst,node->dt);
+	}
+	
+	/* Delta: Change From Last Record */
+	*dst++ = node->type;
+	dst = APP_put_varint(dst,APP_ZIGZAG(node->x - journalLast.x));
+	dst = APP_put_varint(dst,APP_ZIGZAG(node->y - journalLast.y));
+	return APP_put_varint(dst,(uint16_t)(node->dt - journalLast.dt));
+}
+
+const uint8_t * APP_decode_node(const uint8_t * src, NodeRecord * node)
+{
+	/* Decode Over Previous Record ('node' Holds It Unless This Is a Key) */
+	uint32_t val;
+	uint8_t tag = *src++;
+	node->type = tag & DAT_TAG_TYPE;
+	
+	if(tag & DAT_TAG_KEY)
+	{
+		src = APP_get_varint(src,&val);	node->quad.x = APP_UNZIGZAG(val);
+		src = APP_get_varint(src,&val);	node->quad.y = APP_UNZIGZAG(val);
+		src = APP_get_varint(src,&val);	node->x = APP_UNZIGZAG(val);
+		src = APP_get_varint(src,&val);	node->y = APP_UNZIGZAG(val);
+		src = APP_get_varint(src,&val);	node->dt = val;
+	}
+	else
+	{
+		src = APP_get_varint(src,&val);	node->x += APP_UNZIGZAG(val);
+		src = APP_get_varint(src,&val);	node->y += APP_UNZIGZAG(val);
+		src = APP_get_varint(src,&val);	node->dt += val;
+	}
+	return src;
+}
+
+// ASSUMES TRACE HANDLER HAS CURRENT REFERENCE AND POSITION
+uint8_t APP_write_node(DataType type)
+{
+	/* Calculate Offset of Current Node */
+	Vector2 tmpOff = {trace.ref.x - trace.pos.x, trace.ref.y - trace.pos.y};
+	
+	/* Build Generic Payload */
+	NodeRecord node;
+	LCD_setIconState(CARDICON,1);
+	node.type = type;									// [TYPE]
+	node.quad = trace.quad;								// [QUADRANT]
+	node.reserved = 0;
+
+	/* Buffer Node-Specific Payload Section */
+	switch(type)
+	{
+		case D_NORMALNODE:		
+			/* Draw Node (Stored Through the Simplifier) */
+			LCD_drawCircle_filled(
+				NAVSCREEN_MAP_X0 - (tmpOff.x + trace.view.x) / D2PX, 
+				NAVSCREEN_MAP_Y0 + (tmpOff.y + trace.view.y) / D2PX,
+				NODESIZE_S,
+				NODECOLOR_NORMAL);
+				
+			/* Update DIRA Pane */
+			LCD_setText(NAVSCREEN_DIRA_TEXTX,TFTHEIGHT-18,NAVSCREEN_DIRA_SIZE,NODECOLOR_NORMAL,NAVSCREEN_SCREENCOLOR);
+			APP_print_fix();
+			LCD_drawArrow(NAVSCREEN_DIRA_TEXTX+40,NAVSCREEN_DIRA_TEXTY,APP_course2rot(),NODECOLOR_NORMAL,NAVSCREEN_SCREENCOLOR);
+			
+			/* Update DIRB Pane */
+			LCD_drawArrow(NAVSCREEN_DIRB_TEXTX+40,NAVSCREEN_DIRB_TEXTY,APP_lastSuper2rot(),NODECOLOR_SUPER,NAVSCREEN_SCREENCOLOR);
+			
+		break;
+		
+		case D_SUPERNODE:
+			/* Buffer Relative Offset */
+			node.x = tmpOff.x;
+			node.y = tmpOff.y;
+		
+			/* Draw Node */
+			LCD_drawCircle_filled(
+				NAVSCREEN_MAP_X0 - (tmpOff.x + trace.view.x) / D2PX, 
+				NAVSCREEN_MAP_Y0 + (tmpOff.y + trace.view.y) / D2PX,
+				NODESIZE,
+				NODECOLOR_SUPER);
+
+			/* Update DIRA Pane */
+			LCD_setText(NAVSCREEN_DIRA_TEXTX,TFTHEIGHT-18,NAVSCREEN_DIRA_SIZE,NODECOLOR_NORMAL,NAVSCREEN_SCREENCOLOR);
+			APP_print_fix();
+			LCD_drawArrow(NAVSCREEN_DIRA_TEXTX+40,NAVSCREEN_DIRA_TEXTY,APP_course2rot(),NODECOLOR_NORMAL,NAVSCREEN_SCREENCOLOR);
+			
+			/* Update DIRB Pane */
+			LCD_setText(NAVSCREEN_DIRB_TEXTX,TFTHEIGHT-18,NAVSCREEN_DIRB_SIZE,NODECOLOR_SUPER,NAVSCREEN_SCREENCOLOR);
+			APP_print_fix();
+			trace.sup.x = trace.pos.x;	trace.sup.y = trace.pos.y;
+			//LCD_drawArrow(NAVSCREEN_DIRB_TEXTX+40,NAVSCREEN_DIRB_TEXTY,APP_lastSuper2rot(),NODECOLOR_SUPER,NAVSCREEN_SCREENCOLOR);
+			LCD_drawRect_filled(NAVSCREEN_DIRB_TEXTX+40,NAVSCREEN_DIRB_TEXTY,29,29,NAVSCREEN_SCREENCOLOR);
+			
+		break;
+
+		case D_ORIGINNODE:
+			/* Buffer Absolute Position */
+			node.x = gps.LONGITUDE;
+			node.y = gps.LATITUDE;
+			
+			/* Draw Node */
+			LCD_drawCircle_filled(
+				NAVSCREEN_MAP_X0 - trace.view.x / D2PX,
+				NAVSCREEN_MAP_Y0 + trace.view.y / D2PX,
+				NODESIZE,
+				NODECOLOR_USER);
+				
+			/* Update DIRA Pane */
+			LCD_setText(NAVSCREEN_DIRA_TEXTX,TFTHEIGHT-18,NAVSCREEN_DIRA_SIZE,NODECOLOR_SUPER,NAVSCREEN_SCREENCOLOR);
+			APP_print_fix();
+			LCD_drawArrow(NAVSCREEN_DIRA_TEXTX+40,NAVSCREEN_DIRA_TEXTY,APP_course2rot(),NODECOLOR_USER,NAVSCREEN_SCREENCOLOR);
+			
+			/* Update DIRB Pane */
+			LCD_setText(NAVSCREEN_DIRB_TEXTX,TFTHEIGHT-18,NAVSCREEN_DIRB_SIZE,NODECOLOR_SUPER,NAVSCREEN_SCREENCOLOR);
+			APP_print_fix();
+			//LCD_drawArrow(NAVSCREEN_DIRB_TEXTX+40,NAVSCREEN_DIRB_TEXTY,APP_lastSuper2rot(),NODECOLOR_USER,NAVSCREEN_SCREENCOLOR);
+			LCD_drawRect_filled(NAVSCREEN_DIRB_TEXTX+40,NAVSCREEN_DIRB_TEXTY,29,29,NAVSCREEN_SCREENCOLOR);
+		break;
+		
+		case D_REFNODE:
+			/* Buffer Absolute Position */
+			node.x = gps.LONGITUDE;
+			node.y = gps.LATITUDE;
+		break;
+		
+		default:
+			node.x = 0;
+			node.y = 0;
+	}
+	
+	/* Normal Nodes Go Through the Simplifier, Anything Else Is Stored Exactly */
+	if(type == D_NORMALNODE)
+	{
+		if(APP_simplify_push(tmpOff,gps.UTC_TIME))	return 1;
+	}
+	else
+	{
+		if(APP_simplify_flush())					return 1;
+		if(APP_append_node(&node,gps.UTC_TIME))		return 1;
+		if(type == D_SUPERNODE){
+			simplify.anchor = tmpOff;
+			simplify.quad = trace.quad;
+			simplify.anchored = 1;
+		}
+	}
+	LCD_setIconState(CARDICON,0);	return 0;
+}
+
+uint8_t APP_append_node(NodeRecord * node, uint32_t time)
+{
+	/* Stage Live Page in RAM: Start a New One, or Reload a Partial One After a Flush */
+	NodePage * page = (NodePage *)disk.buff;
+	if(!journalResident)
+	{
+		if(settings.liveCount == 0)
+		{
+			memset(disk.buff,0,DISK_SECTOR_SIZE);
+			page->time = time;
+			page->date = gps.UTC_DATE;
+			page->eid = settings.entryCount;
+			page->magic = DAT_PAGE_MAGIC;
+			page->prev = journalPrev;
+		}
+		else if(DISK_read(settings.liveSector)) return 1;
+		journalResident = 1;
+	}
+	
+	/* Time Kept Relative to Page, Across Midnight */
+	node->dt = (time + GPS_SECONDS_PER_DAY - page->time) % GPS_SECONDS_PER_DAY;
+	
+	/* Key Records Restart the Stream: Page Start, Non-Normal Nodes, New Quadrant */
+	uint8_t key = journalKey || page->count == 0 || node->type != D_NORMALNODE
+		|| (journalLast.type != D_NORMALNODE && journalLast.type != D_SUPERNODE)
+		|| journalLast.quad.x != node->quad.x || journalLast.quad.y != node->quad.y;
+	
+	/* Append Record */
+	uint8_t * end = APP_encode_node(page->body + page->used,node,key);
+	page->used = end - page->body;
+	page->count++;
+	settings.liveCount = page->count;
+	journalLast = *node;
+	journalKey = 0;
+	journalDirty = 1;
+	
+	/* Count the Record Into the Trace's Summary */
+	trace.summary.end = settings.liveSector;
+	trace.summary.t1 = APP_STAMP(gps.UTC_DATE,time);
+	if(trace.summary.nodes++ == 0) trace.summary.t0 = trace.summary.t1;
+	
+	/* Grow the Current Visit's Extent */
+	if(trace.visitOpen)
+	{
+		trace.visit.count++;
+		if(trace.visit.count == 1 || page->count == 1) trace.visit.pages++;
+		if(node->type == D_NORMALNODE || node->type == D_SUPERNODE)
+		{
+			if(node->x < trace.visit.x0) trace.visit.x0 = node->x;
+			if(node->x > trace.visit.x1) trace.visit.x1 = node->x;
+			if(node->y < trace.visit.y0) trace.visit.y0 = node->y;
+			if(node->y > trace.visit.y1) trace.visit.y1 = node->y;
+			APP_index_push(node,DAT_ADDR(settings.liveSector,page->count - 1));
+		}
+		if(tileOn && (node->type == D_NORMALNODE || node->type == D_SUPERNODE || node->type == D_ORIGINNODE))
+		{
+			shared.tilePending[tilePendingCount].x = node->type == D_ORIGINNODE ? 0 : node->x;
+			shared.tilePending[tilePendingCount].y = node->type == D_ORIGINNODE ? 0 : node->y;
+			shared.tilePending[tilePendingCount++].type = node->type;
+		}
+	}
+	
+	/* Program the Card Only Once the Page Can't Hold Another Record */
+	uint8_t sealed = page->used + DAT_RECORD_MAX > DAT_PAGE_BODY;
+	if(sealed){
+		page->next = settings.freeSector++;
+		checkpointDue = 1;
+		if(APP_journal_flush()) return 1;
+	}
+	
+	/* Merge Pending Index Entries While the Buffer Is Free, Or Once They Fill */
+	if(indexPendingCount && (sealed || indexPendingCount == INDEX_PENDING)){
+		if(APP_journal_flush()) return 1;
+		if(APP_index_flush()) return 1;
+	}
+	
+	/* Paint Pending Nodes Into the Tile Once They Fill */
+	if(tilePendingCount == DAT_TILE_NODES){
+		if(APP_journal_flush()) return 1;
+		if(APP_tile_merge()) return 1;
+	}
+	
+	/* Checkpoint While the Buffer Is Free (Page Sealed or Tile Merged) */
+	return journalResident ? 0 : APP_checkpoint(0);
+}
+
+/***************************************************************************************************
+	Quadrant Index
+		Each quadrant's router is followed by an index sector (IndexPage) listing its nodes, one
+		per DAT_INDEX_MERGE neighbourhood, with the record each came from; a full sector chains
+		on to another. Entries of the open visit gather in RAM and are merged into the chain when
+		the visit closes, a page seals or INDEX_PENDING of them are waiting. A query reads the
+		directory and index sectors of the (at most four) quadrants its radius reaches, and no
+		node pages.
+		
+***************************************************************************************************/
+void APP_index_push(const NodeRecord * node, uint32_t addr)
+{
+	/* Clamp to Entry Range (Offsets Overshoot the Pane By Under a Step) */
+	int8_t x = (node->x > INT8_MAX) ? INT8_MAX : (node->x < INT8_MIN) ? INT8_MIN : node->x;
+	int8_t y = (node->y > INT8_MAX) ? INT8_MAX : (node->y < INT8_MIN) ? INT8_MIN : node->y;
+	
+	/* Skip Nodes Already Covered By a Pending Entry */
+	for(uint8_t i = 0; i < indexPendingCount; i++)
+		if(abs(shared.indexPending[i].x - x) < DAT_INDEX_MERGE && abs(shared.indexPending[i].y - y) < DAT_INDEX_MERGE) return;
+	if(indexPendingCount == INDEX_PENDING) return;
+	
+	/* Queue Entry */
+	shared.indexPending[indexPendingCount].x = x;
+	shared.indexPending[indexPendingCount].y = y;
+	shared.indexPending[indexPendingCount].addr = addr;
+	indexPendingCount++;
+}
+
+// ASSUMES DISK BUFFER IS FREE (JOURNAL FLUSHED)
+uint8_t APP_index_flush()
+{
+	/* Nothing Pending */
+	if(indexPendingCount == 0) return 0;
+	uint8_t n = indexPendingCount;
+	indexPendingCount = 0;
+	
+	/* Walk the Visit's Index Chain, Dropping Entries Covered By One Already Listed */
+	IndexPage * index = (IndexPage *)disk.buff;
+	uint32_t sector = trace.visitRouter + 1;
+	while(1)
+	{
+		/* Start a Sector Over If It Never Made It to the Card */
+		if(DISK_read(sector)) return 1;
+		if(index->magic != DAT_PAGE_MAGIC || index->type != D_INDEX){
+			memset(disk.buff,0,DISK_SECTOR_SIZE);
+			index->magic = DAT_PAGE_MAGIC;
+			index->type = D_INDEX;
+		}
+		uint16_t listed = (index->count < DAT_INDEX_ENTRIES) ? index->count : DAT_INDEX_ENTRIES;
+		for(uint8_t i = 0; i < n; )
+		{
+			uint16_t j;
+			for(j = 0; j < listed; j++)
+				if(abs(index->entry[j].x - shared.indexPending[i].x) < DAT_INDEX_MERGE
+				&& abs(index->entry[j].y - shared.indexPending[i].y) < DAT_INDEX_MERGE) break;
+			if(j < listed) shared.indexPending[i] = shared.indexPending[--n];
+			else i++;
+		}
+		if(!index->next) break;
+		sector = index->next;
+	}
+	
+	/* Append the Rest to the Last Sector, Chaining On a Fresh One Whenever It Fills */
+	while(1)
+	{
+		while(n && index->count < DAT_INDEX_ENTRIES) index->entry[index->count++] = shared.indexPending[--n];
+		uint32_t next = n ? settings.freeSector++ : 0;
+		index->next = next;
+		disk.buffIt = DISK_SECTOR_SIZE;
+		if(DISK_write(sector)) return 1;
+		if(!next) return 0;
+		sector = next;
+		memset(disk.buff,0,DISK_SECTOR_SIZE);
+		index->magic = DAT_PAGE_MAGIC;
+		index->type = D_INDEX;
+	}
+}
+
+// USES DISK BUFFER; FILLS 'hits' WITH THE LISTED NODES WITHIN 'radius' (<= MAPXBOUND) OF (x,y), NEAREST FIRST, RETURNS HOW MANY (<= 'max')
+uint8_t APP_index_within(uint32_t directory, int32_t x, int32_t y, uint16_t radius, IndexHit * hits, uint8_t max)
+{
+	IndexPage * index = (IndexPage *)disk.buff;
+	uint8_t found = 0;
+	
+	/* Quadrant Holding (x,y), and Which Neighbours the Radius Reaches Into */
+	Vector2 home;
+	home.x = (x + MAPXBOUND + (x < -MAPXBOUND ? 1 - NAVSCREEN_MAP_PANEW * D2PX : 0)) / (NAVSCREEN_MAP_PANEW * D2PX);
+	home.y = (y + MAPYBOUND + (y < -MAPYBOUND ? 1 - NAVSCREEN_MAP_PANEH * D2PX : 0)) / (NAVSCREEN_MAP_PANEH * D2PX);
+	int32_t cx = x - (int32_t)home.x * (NAVSCREEN_MAP_PANEW * D2PX);
+	int32_t cy = y - (int32_t)home.y * (NAVSCREEN_MAP_PANEH * D2PX);
+	int8_t sx = (cx + (int32_t)radius > MAPXBOUND) ? 1 : (cx - (int32_t)radius < -MAPXBOUND) ? -1 : 0;
+	int8_t sy = (cy + (int32_t)radius > MAPYBOUND) ? 1 : (cy - (int32_t)radius < -MAPYBOUND) ? -1 : 0;
+	
+	/* Scan Each Candidate Quadrant's Index Chain */
+	for(uint8_t q = 0; q < 4; q++)
+	{
+		Vector2 quad = home;
+		if(q & 1){ if(!sx) continue; quad.x += sx; }
+		if(q & 2){ if(!sy) continue; quad.y += sy; }
+		uint32_t router = APP_find_router(directory,quad,NULL);
+		
+		/* Entries Hold Offsets From the Quadrant Reference (ref - pos) */
+		int32_t ox = (int32_t)quad.x * (NAVSCREEN_MAP_PANEW * D2PX) - x;
+		int32_t oy = (int32_t)quad.y * (NAVSCREEN_MAP_PANEH * D2PX) - y;
+		for(uint32_t sector = router ? router + 1 : 0; sector; sector = index->next)
+		{
+			if(DISK_read(sector)) return found;
+			if(index->magic != DAT_PAGE_MAGIC || index->type != D_INDEX) break;
+			for(uint16_t i = 0; i < index->count && i < DAT_INDEX_ENTRIES; i++)
+			{
+				int32_t dx = ox - index->entry[i].x;
+				int32_t dy = oy - index->entry[i].y;
+				if(labs(dx) > radius || labs(dy) > radius) continue;
+				uint32_t d2 = (uint32_t)(dx * dx) + (uint32_t)(dy * dy);
+				if(d2 > (uint32_t)radius * radius) continue;
+				
+				/* Insert By Distance, Dropping the Farthest Once 'max' Are Held */
+				uint8_t at = (found < max) ? found++ : max;
+				for(; at && hits[at - 1].dist2 > d2; at--)
+					if(at < max) hits[at] = hits[at - 1];
+				if(at < max){
+					hits[at].addr = index->entry[i].addr;
+					hits[at].dist2 = d2;
+				}
+			}
+		}
+	}
+	return found;
+}
+
+/***************************************************************************************************
+	Track Simplifier
+		Normal nodes are held back while the track runs straight. A new point continues the run if
+		every held point projects onto the chord from the anchor (last stored node) to it, and lies
+		within TRACE_TOLERANCE_CM of that chord. Once it doesn't, or TRACE_WINDOW points are held,
+		the newest held point is stored and becomes the anchor. Its own chord was checked when it
+		arrived, so every dropped point stays within the budget.
+		Super/origin/reference nodes flush the run and are stored exactly, as are the last node
+		before and the first node after a quadrant crossing. The budget is converted at the
+		latitude scale and rounded down (50 cm allows 2 map units, 37 cm), so it is tighter still
+		east-west.
+		
+***************************************************************************************************/
+uint8_t APP_simplify_push(Vector2 off, uint32_t time)
+{
+	/* First Node in a Quadrant Is Stored Exactly */
+	if(!simplify.anchored || simplify.quad.x != trace.quad.x || simplify.quad.y != trace.quad.y)
+	{
+		if(APP_simplify_flush()) return 1;
+		simplify.quad = trace.quad;
+		simplify.anchored = 1;
+		simplify.held[0] = off;
+		simplify.heldTime = time;
+		simplify.count = 1;
+		return APP_simplify_flush();
+	}
+	
+	/* Close the Run at the Newest Held Point */
+	if(simplify.count == TRACE_WINDOW || APP_simplify_deviates(off))
+		if(APP_simplify_flush()) return 1;
+	
+	/* Hold Point */
+	simplify.held[simplify.count++] = off;
+	simplify.heldTime = time;
+	return 0;
+}
+
+uint8_t APP_simplify_deviates(Vector2 off)
+{
+	/* Chord From Anchor to New Point */
+	int32_t cx = off.x - simplify.anchor.x;
+	int32_t cy = off.y - simplify.anchor.y;
+	uint32_t len2 = cx * cx + cy * cy;
+	uint32_t tol2 = len2 * (APP_CM2POS(TRACE_TOLERANCE_CM) * APP_CM2POS(TRACE_TOLERANCE_CM));
+	if(len2 == 0) return simplify.count != 0;
+	
+	/* Test Every Held Point */
+	for(uint8_t i = 0; i < simplify.count; i++)
+	{
+		int32_t px = simplify.held[i].x - simplify.anchor.x;
+		int32_t py = simplify.held[i].y - simplify.anchor.y;
+		
+		/* Projects Behind the Anchor or Past the New Point (Track Doubled Back) */
+		int32_t dot = px * cx + py * cy;
+		if(dot < 0 || (uint32_t)dot > len2) return 1;
+		
+		/* Distance From Chord = |p x c| / |c|, Compared Squared */
+		uint32_t cross = labs(px * cy - py * cx);
+		if(cross > 0xFFFF || cross * cross > tol2) return 1;
+	}
+	return 0;
+}
+
+uint8_t APP_simplify_flush()
+{
+	/* Nothing Held */
+	if(simplify.count == 0) return 0;
+	
+	/* Store Newest Held Point; It Anchors the Next Run */
+	NodeRecord node;
+	node.x = simplify.held[simplify.count - 1].x;
+	node.y = simplify.held[simplify.count - 1].y;
+	node.quad = simplify.quad;
+	node.type = D_NORMALNODE;
+	node.reserved = 0;
+	simplify.anchor = simplify.held[simplify.count - 1];
+	simplify.count = 0;
+	return APP_append_node(&node,simplify.heldTime);
+}
+
+/***************************************************************************************************
+	Node Journal
+		Nodes are staged in the live page held in disk.buff and reach the card a whole sector at a
+		time. Anything else that needs disk.buff (router, manifest) must call APP_journal_flush()
+		first, as must leaving the trace (APP_startMode_main, after APP_simplify_flush()). A flushed
+		partial page is read back before the next append.
+		
+***************************************************************************************************/
+uint8_t APP_journal_flush()
+{
+	/* Nothing Staged */
+	if(!journalResident) return 0;
+	
+	/* Buffer Is Released Either Way */
+	NodePage * page = (NodePage *)disk.buff;
+	uint32_t next = page->next;
+	journalResident = 0;
+	
+	/* Write Staged Page */
+	if(journalDirty)
+	{
+		journalDirty = 0;
+		disk.buffIt = DAT_PAGE_HEADER + page->used;
+		if(DISK_write(settings.liveSector)) return 1;
+	}
+	
+	/* Move On Once Page Is Sealed */
+	if(next){
+		journalPrev = settings.liveSector;
+		settings.liveSector = next;
+		settings.liveCount = 0;
+	}
+	return 0;
+}
+
+uint8_t APP_write_manifest(DataType type)
+{
+	/* Commit Staged Nodes Before Reusing the Disk Buffer, and Close the Trace Before */
+	if(APP_journal_flush()) return 1;
+	if(APP_close_manifest()) return 1;
+	if(settings.entryCount >= MAN_BLOCKLEN * MAN_ENTRIES) return 1;
+	
+	/* If 'type' is M_TRACE */
+	if(type == M_TRACE)
+	{
+		/* Start Trace On a Fresh Page */
+		if(settings.liveCount){
+			settings.liveSector = settings.freeSector++;
+			settings.liveCount = 0;
+		}
+		journalKey = 1;
+		journalPrev = 0;
+		simplify.anchored = 0;
+		simplify.count = 0;
+		trace.visitOpen = 0;
+		indexPendingCount = 0;
+		
+		/* Update Trace Handler */
+		trace.startSector = settings.freeSector++;				// Allocate quadrant directory
+		if(APP_create_directory(trace.startSector)) return 1;	// ...
+		trace.quad.x = 0;										// Set starting quadrant
+		trace.quad.y = 0;										// ...
+		trace.originLat = gps.LATITUDE;						// Set origin fix
+		trace.originLon = gps.LONGITUDE;					// ...
+		trace.pos.x = 0;										// Set starting position
+		trace.pos.y = 0;										// ...
+		trace.sup.x = trace.pos.x;								// Set super position
+		trace.sup.y = trace.pos.y;								// ...
+		trace.ref.x = trace.pos.x;								// Set reference position
+		trace.ref.y = trace.pos.y;								// ...
+		trace.view.x = 0;										// Centre view on the reference
+		trace.view.y = 0;										// ...
+	}
+	
+	/* Open Entry: A Trace's Summary Grows in RAM Until It Closes */
+	ManifestEntry single;
+	ManifestEntry * entry = (type == M_TRACE) ? &trace.summary : &single;
+	memset(entry,0,sizeof(ManifestEntry));
+	entry->magic = DAT_PAGE_MAGIC;								// ***
+	entry->type = type;											// [ENTRY TYPE]
+	entry->closed = (type != M_TRACE);							// [SINGLE COORDINATE IS COMPLETE]
+	entry->start = settings.liveSector;							// [START SECTOR]
+	entry->end = settings.liveSector;							// [END SECTOR]
+	entry->directory = (type == M_TRACE) ? trace.startSector : 0;	// [DIRECTORY SECTOR]
+	entry->t0 = APP_STAMP(gps.UTC_DATE,gps.UTC_TIME);			// [START STAMP]
+	entry->t1 = entry->t0;										// ...
+	entry->lon0 = (type == M_TRACE) ? INT32_MAX : gps.LONGITUDE;	// [BOUNDING BOX, EMPTY FOR A TRACE]
+	entry->lat0 = (type == M_TRACE) ? INT32_MAX : gps.LATITUDE;	// ...
+	entry->lon1 = (type == M_TRACE) ? INT32_MIN : gps.LONGITUDE;	// ...
+	entry->lat1 = (type == M_TRACE) ? INT32_MIN : gps.LATITUDE;	// ...
+	if(type == M_TRACE) trace.tripFix = trace.tripMoving = trace.tripStopped = 0;	// [TRIP STATISTICS START AT THE NEXT FIX]
+	
+	/* Write Entry Into Manifest */								// ***
+	LCD_setIconState(CARDICON,1);								// ICON ON
+	if(APP_manifest_put(++settings.entryCount,entry)) return 1;	// [..to Manifest]
+	if(MAN_ENTRY_SLOT(settings.entryCount) == MAN_ENTRIES - 1 && settings.entryCount < MAN_BLOCKLEN * MAN_ENTRIES)
+		if(DISK_wipe(MAN_ENTRY_SECTOR(settings.entryCount) + 1,1)) return 1;	// [..Blanking the Next Sector Once Full]
+	if(APP_checkpoint(1)) return 1;								// [..and Checkpoint]
+	LCD_setIconState(CARDICON,0); return 0;						// ICON OFF
+}
+
+uint8_t APP_close_manifest()
+{
+	/* Only an Open Trace Has a Summary to Write */
+	if(trace.summary.magic != DAT_PAGE_MAGIC || trace.summary.closed) return 0;
+	if(APP_journal_flush()) return 1;
+	trace.summary.closed = 1;
+	
+	/* End the Page Chain: a Sealed Page's Next Sector Was Never Written, and May Hold Data From Before a Format */
+	if(settings.liveCount == 0){
+		memset(disk.buff,0,DISK_SECTOR_SIZE);
+		disk.buffIt = DISK_SECTOR_SIZE;
+		if(DISK_write(settings.liveSector)) return 1;
+	}
+	if(APP_manifest_put(settings.entryCount,&trace.summary)) return 1;
+	return APP_checkpoint(1);
+}
+
+uint8_t APP_manifest_put(uint16_t eid, const ManifestEntry * entry)
+{
+	/* Keep the Sector's Other Entries (Its First Slot Starts a Clean Sector) */
+	uint32_t sector = MAN_ENTRY_SECTOR(eid);
+	if(MAN_ENTRY_SLOT(eid) == 0) memset(disk.buff,0,DISK_SECTOR_SIZE);
+	else if(DISK_read(sector)) return 1;
+	((ManifestEntry *)disk.buff)[MAN_ENTRY_SLOT(eid)] = *entry;
+	disk.buffIt = DISK_SECTOR_SIZE;
+	return DISK_write(sector);
+}
+
+uint8_t APP_manifest_get(uint16_t eid, ManifestEntry * entry)
+{
+	/* Read One Entry, Leaving the Disk Buffer Alone */
+	if(eid == 0 || eid > settings.entryCount) return 1;
+	if(DISK_read_part(MAN_ENTRY_SECTOR(eid),MAN_ENTRY_SLOT(eid) * sizeof(ManifestEntry),(uint8_t *)entry,sizeof(ManifestEntry))) return 1;
+	return entry->magic != DAT_PAGE_MAGIC;
+}
+
+// TAKES THE DISK BUFFER
+uint8_t APP_manifest_rescan()
+{
+	/* Entries Are Written In Order Up to a Blank Slot: Count Them, Keeping the Newest Trace and the Highest Sector Any Holds */
+	const ManifestEntry * table = (const ManifestEntry *)disk.buff;
+	ManifestEntry last;
+	uint16_t eid = 0, lastTrace = 0;
+	uint32_t top = DAT_SECTOR;
+	while(eid < MAN_BLOCKLEN * MAN_ENTRIES)
+	{
+		if(MAN_ENTRY_SLOT(eid + 1) == 0 && DISK_read(MAN_ENTRY_SECTOR(eid + 1))) return 1;
+		const ManifestEntry * entry = &table[MAN_ENTRY_SLOT(eid + 1)];
+		if(entry->magic != DAT_PAGE_MAGIC) break;
+		if(entry->start > top) top = entry->start;
+		if(entry->end > top) top = entry->end;
+		if(entry->directory > top) top = entry->directory;
+		if(entry->type == M_TRACE){
+			last = *entry;
+			lastTrace = eid + 1;
+		}
+		eid++;
+	}
+	
+	/* The Newest Trace Handed Out Every Sector Above the Others: Follow Its Pages On From the Last One Recorded */
+	if(lastTrace)
+	{
+		NodePage * page = (NodePage *)disk.buff;
+		NodeRecord node;
+		uint32_t sector = last.closed ? last.end : last.start;
+		uint32_t from = 0;
+		int32_t originLon = 0, originLat = 0;
+		uint8_t origin = 0;
+		if(!last.closed) last.nodes = 0;
+		while(sector)
+		{
+			if(DISK_read(sector)) return 1;
+			if(page->magic != DAT_PAGE_MAGIC || page->eid != lastTrace || (from && page->prev != from)) break;
+			if(sector > top) top = sector;
+			if(page->next > top) top = page->next;						// Allocated as the page sealed, maybe never written
+			
+			/* An Open Trace Is Summarised Again From Its Pages: Its Box From the Fixes Its Nodes Were Written At, */
+			/* Each Origin + Quadrant * Pane - Offset (Its Trip Statistics Were Only In RAM and Stay 0) */
+			if(!last.closed && page->count){
+				const uint8_t * src = page->body;
+				for(uint8_t i = 0; i < page->count; i++)
+				{
+					src = APP_decode_node(src,&node);
+					int32_t lon, lat;
+					switch(node.type){
+						case D_ORIGINNODE:
+							lon = originLon = node.x;
+							lat = originLat = node.y;
+							origin = 1;
+							break;
+						case D_NORMALNODE:
+						case D_SUPERNODE:
+							if(!origin) continue;
+							lon = originLon + APP_POS2FIX((int32_t)node.quad.x * (NAVSCREEN_MAP_PANEW * D2PX) - node.x);
+							lat = originLat + APP_POS2FIX((int32_t)node.quad.y * (NAVSCREEN_MAP_PANEH * D2PX) - node.y);
+							break;
+						default:
+							continue;										// Reference nodes repeat the next node's fix
+					}
+					if(lon < last.lon0) last.lon0 = lon;
+					if(lon > last.lon1) last.lon1 = lon;
+					if(lat < last.lat0) last.lat0 = lat;
+					if(lat > last.lat1) last.lat1 = lat;
+				}
+				last.end = sector;
+				last.nodes += page->count;
+				last.t1 = APP_STAMP(page->date,page->time) + node.dt;
+			}
+			from = sector;
+			sector = page->next;
+		}
+		
+		/* ...And Its Quadrant Directory, With the Router Sectors of Each Quadrant */
+		DirectoryPage * dir = (DirectoryPage *)disk.buff;
+		for(sector = last.directory; sector; sector = dir->next)
+		{
+			if(DISK_read(sector)) return 1;
+			if(dir->magic != DAT_PAGE_MAGIC || dir->type != D_DIRECTORY) break;
+			if(sector > top) top = sector;
+			if(dir->next > top) top = dir->next;
+			for(uint8_t i = 0; i < DAT_DIR_SLOTS; i++)
+			{
+				uint32_t router = dir->slot[i].router;
+				if(router && router + DAT_ROUTER_SECTORS - 1 > top) top = router + DAT_ROUTER_SECTORS - 1;
+				
+				/* Index Sectors Chained On Past the Router Block (Allocated Upwards, So a Link Back Ends It) */
+				for(uint32_t chain = router ? router + 1 : 0, next; chain; chain = (next > chain) ? next : 0)
+				{
+					if(DISK_read_part(chain,offsetof(IndexPage,next),(uint8_t *)&next,sizeof(next))) return 1;
+					if(next > top) top = next;
+				}
+			}
+		}
+	}
+	
+	/* Allocate Past All of It, Starting Over From No Trace */
+	settings.entryCount = eid;
+	settings.freeSector = top + 1;
+	settings.liveSector = settings.freeSector++;
+	settings.liveCount = 0;
+	memset(&trace,0,sizeof(trace));
+	journalPrev = 0;
+	journalResident = 0;
+	journalDirty = 0;
+	journalKey = 1;
+	simplify.anchored = 0;
+	simplify.count = 0;
+	indexPendingCount = 0;
+	tilePendingCount = 0;
+	tileOn = 0;
+	
+	/* Close the Newest Trace If It Was Left Open, Then Checkpoint So the Next Boot Needn't Rescan */
+	if(lastTrace && !last.closed){
+		last.closed = 1;
+		if(APP_manifest_put(lastTrace,&last)) return 1;
+	}
+	return APP_checkpoint(1);
+}
+
+uint16_t APP_manifest_find_time(uint32_t stamp)
+{
+	/* Start Stamps Only Grow: Bisect the Sectors on Their First Entry */
+	ManifestEntry entry;
+	if(settings.entryCount == 0) return 0;
+	uint16_t lo = 0, hi = (settings.entryCount - 1) / MAN_ENTRIES;
+	while(lo < hi)
+	{
+		uint16_t mid = (lo + hi + 1) / 2;
+		if(APP_manifest_get(mid * MAN_ENTRIES + 1,&entry)) return 0;
+		if(entry.t0 <= stamp) lo = mid;
+		else hi = mid - 1;
+	}
+	
+	/* Then Take the Last Entry of That Sector Started by 'stamp' (Takes the Disk Buffer) */
+	const ManifestEntry * table = (const ManifestEntry *)disk.buff;
+	uint16_t first = lo * MAN_ENTRIES + 1, found = 0;
+	if(DISK_read(MAN_SECTOR + lo)) return 0;
+	for(uint8_t i = 0; i < MAN_ENTRIES && first + i <= settings.entryCount; i++)
+	{
+		if(table[i].magic != DAT_PAGE_MAGIC || table[i].t0 > stamp) break;
+		found = first + i;
+	}
+	return found;
+}
+
+uint16_t APP_manifest_find_region(int32_t lon, int32_t lat)
+{
+	/* Boxes Don't Sort: Scan the Table Newest First, a Sector at a Time (Takes the Disk Buffer) */
+	const ManifestEntry * table = (const ManifestEntry *)disk.buff;
+	for(uint16_t eid = settings.entryCount; eid > 0; eid--)
+	{
+		if(eid == settings.entryCount || MAN_ENTRY_SLOT(eid) == MAN_ENTRIES - 1)
+			if(DISK_read(MAN_ENTRY_SECTOR(eid))) return 0;
+		const ManifestEntry * entry = &table[MAN_ENTRY_SLOT(eid)];
+		if(entry->magic == DAT_PAGE_MAGIC && entry->type == M_TRACE && entry->closed
+			&& lon >= entry->lon0 && lon <= entry->lon1 && lat >= entry->lat0 && lat <= entry->lat1) return eid;
+	}
+	return 0;
+}
+
+/***************************************************************************************************
+	Checkpoints
+		Settings and trace state are checkpointed into a ring of sectors (see Checkpoint) when
+		a trace opens or closes, a quadrant is entered or left, a page seals, and before the
+		sectors the last checkpoint reserved run low. Node pages go to the card first, so on
+		boot the newest whole checkpoint is restored and the records written after it are
+		counted back in by following the live page on, reading CHK_BLOCKLEN checkpoints and a
+		page or two. Only what was still in RAM (staged records, held nodes, pending index and
+		tile entries) is lost. A card without a whole checkpoint is still mounted: its entries
+		are counted from the manifest and sectors are handed out past everything the newest
+		trace reaches (APP_manifest_rescan), which closes that trace if it was left open.
+		
+***************************************************************************************************/
+// ASSUMES DISK BUFFER IS FREE (JOURNAL FLUSHED)
+uint8_t APP_checkpoint(uint8_t force)
+{
+	/* Only Once Something Worth Keeping Changed, or the Reserved Sectors Run Low */
+	if(!force && !checkpointDue && settings.freeSector + CHK_SLACK <= checkpointLimit) return 0;
+	checkpointDue = 0;
+	checkpointLimit = settings.freeSector + CHK_RESERVE;
+	
+	/* Stamp Record With the Next Sequence Number and Its CRC, Over the Oldest in the Ring */
+	Checkpoint * chk = (Checkpoint *)disk.buff;
+	memset(disk.buff,0,DISK_SECTOR_SIZE);
+	chk->magic = DAT_PAGE_MAGIC;
+	chk->seq = ++checkpointSeq;
+	chk->limit = checkpointLimit;
+	chk->prev = journalPrev;
+	chk->settings = settings;
+	chk->trace = trace;
+	chk->crc = APP_crc16((const uint8_t *)disk.buff + CHK_CRC_FROM,sizeof(Checkpoint) - CHK_CRC_FROM);
+	disk.buffIt = DISK_SECTOR_SIZE;
+	return DISK_write(CHK_SECTOR + checkpointSeq % CHK_BLOCKLEN);
+}
+
+uint8_t APP_checkpoint_recover()
+{
+	/* Newest Whole Record in the Ring Wins */
+	Checkpoint * chk = (Checkpoint *)disk.buff;
+	uint8_t best = CHK_BLOCKLEN;
+	for(uint8_t i = 0; i < CHK_BLOCKLEN; i++)
+	{
+		if(DISK_read(CHK_SECTOR + i)) return 1;
+		if(chk->magic != DAT_PAGE_MAGIC || chk->crc != APP_crc16((const uint8_t *)disk.buff + CHK_CRC_FROM,sizeof(Checkpoint) - CHK_CRC_FROM)) continue;
+		if(best == CHK_BLOCKLEN || chk->seq > checkpointSeq){
+			best = i;
+			checkpointSeq = chk->seq;
+		}
+	}
+	if(best == CHK_BLOCKLEN) return 1;
+	
+	/* Restore Where the Card Was Left Off (Settings Came From the Superblock); Sectors Below the Reserve's End May Already Be Handed Out */
+	if(DISK_read(CHK_SECTOR + best)) return 1;
+	settings.entryCount = chk->settings.entryCount;
+	settings.liveSector = chk->settings.liveSector;
+	settings.liveCount = chk->settings.liveCount;
+	settings.freeSector = chk->limit;
+	trace = chk->trace;
+	journalPrev = chk->prev;
+	journalResident = 0;
+	journalDirty = 0;
+	journalKey = 1;
+	simplify.anchored = 0;
+	simplify.count = 0;
+	indexPendingCount = 0;
+	tilePendingCount = 0;
+	tileOn = 0;
+	
+	/* An Open Trace Picks Up Its Records Past the Checkpoint */
+	if(trace.summary.magic == DAT_PAGE_MAGIC && !trace.summary.closed)
+	{
+		/* A Visit Whose Extent Already Reached Its Router Was Closed (Its Records Are All In It) */
+		RouterPage * router = (RouterPage *)disk.buff;
+		uint8_t committed = 0;
+		if(trace.visitOpen)
+		{
+			if(DISK_read(trace.visitRouter)) return 1;
+			committed = router->magic == DAT_PAGE_MAGIC && router->count && router->ext[router->count - 1].addr == trace.visit.addr;
+			if(committed) trace.visitOpen = 0;
+		}
+		
+		/* Else Records In the Quadrant Past the Checkpoint Extend Its Visit, Or Start One */
+		else
+		{
+			trace.visit.count = 0;
+			trace.visit.pages = 0;
+			trace.visit.x0 = trace.visit.y0 = INT8_MAX;
+			trace.visit.x1 = trace.visit.y1 = INT8_MIN;
+		}
+		
+		/* Follow the Live Page On Until a Page That Never Reached the Card */
+		NodePage * page = (NodePage *)disk.buff;
+		NodeRecord node;
+		for(uint16_t n = 0; n < CHK_RESERVE; n++)
+		{
+			if(DISK_read(settings.liveSector)) return 1;
+			if(page->magic != DAT_PAGE_MAGIC || page->eid != settings.entryCount || page->prev != journalPrev || page->count < settings.liveCount) break;
+			
+			/* Count Records Past the Checkpoint Into the Summary, and the Visit's Quadrant Into It */
+			const uint8_t * src = page->body;
+			for(uint8_t i = 0; i < page->count; i++)
+			{
+				src = APP_decode_node(src,&node);
+				if(i < settings.liveCount) continue;
+				trace.summary.end = settings.liveSector;
+				trace.summary.t1 = APP_STAMP(page->date,page->time) + node.dt;
+				if(trace.summary.nodes++ == 0) trace.summary.t0 = trace.summary.t1;
+				if(committed || node.quad.x != trace.quad.x || node.quad.y != trace.quad.y) continue;
+				if(trace.visit.count++ == 0) trace.visit.addr = DAT_ADDR(settings.liveSector,i);
+				if(trace.visit.count == 1 || i == 0) trace.visit.pages++;
+				if(node.type == D_NORMALNODE || node.type == D_SUPERNODE)
+				{
+					if(node.x < trace.visit.x0) trace.visit.x0 = node.x;
+					if(node.x > trace.visit.x1) trace.visit.x1 = node.x;
+					if(node.y < trace.visit.y0) trace.visit.y0 = node.y;
+					if(node.y > trace.visit.y1) trace.visit.y1 = node.y;
+				}
+			}
+			settings.liveCount = page->count;
+			
+			/* Sealed Pages Go On to the Next */
+			if(!page->next) break;
+			journalPrev = settings.liveSector;
+			settings.liveSector = page->next;
+			settings.liveCount = 0;
+		}
+		
+		/* A Visit Opened Since Gets Its Router Back */
+		if(!committed && !trace.visitOpen && trace.visit.count)
+		{
+			uint8_t created;
+			trace.visitRouter = APP_find_router(trace.startSector,trace.quad,&created);
+			if(!trace.visitRouter) return 1;
+			if(!created && DISK_read(trace.visitRouter)) return 1;
+			trace.visitNew = created || router->magic != DAT_PAGE_MAGIC;
+			trace.visitOpen = 1;
+		}
+	}
+	
+	/* Checkpoint the Recovered State Before Anything Else Changes */
+	return APP_checkpoint(1);
+}
+
+uint16_t APP_crc16(const uint8_t * src, uint16_t len)
+{
+	/* CRC-16/CCITT */
+	uint16_t crc = 0xFFFF;
+	while(len--) crc = _crc_ccitt_update(crc,*src++);
+	return crc;
+}
+
+/***************************************************************************************************
+	Retrace Engine
+		Streams a stored trace's nodes forward, or back to its origin (following the pages' 'prev'
+		links), into a RETRACE_AHEAD ring. The card is read from the main loop only
+		(APP_retrace_prefetch, one sector or one RETRACE_BLOCK per pass), so the fix handler
+		(APP_update_retrace) only ever works on RAM. Reverse order is produced a block at a time,
+		decoding the page from its start up to the block (records are delta coded forwards).
+		Once the live position is RETRACE_OFFROUTE from the queued path (from the last node
+		passed on), the fix handler posts it and the main loop looks it up in the quadrant
+		index, restarting the stream at the node found, or raising "Off route" if there is none.
+		
+***************************************************************************************************/
+void APP_startMode_retracing(uint8_t forward)
+{
+	/* Turn Updates and Keys OFF */
+	APP_setUpdateState(0);
+	KEY_setState(0);
+	
+	/* Release the Disk Buffer, Then Open the Newest Trace Through the Fix (Else the Last Entry) */
+	APP_simplify_flush();
+	APP_journal_flush();
+	APP_close_visit();
+	indexPendingCount = tilePendingCount = 0;	// The ring takes their RAM (SharedBuffers)
+	APP_close_manifest();
+	uint16_t eid = GPS_fix_usable(&gps) ? APP_manifest_find_region(gps.LONGITUDE,gps.LATITUDE) : 0;
+	if(eid == 0) eid = settings.entryCount;
+	if(eid == 0 || APP_retrace_open(eid,forward)){
+		SFX_tone(100,200);
+		APP_startMode_main();
+		return;
+	}
+	
+	/* Generate Navigation Screen */
+	LCD_generateScreen(TRACESCREEN);
+	settings.mode = RETRACING;
+	APP_governRate();
+	
+	/* Turn Keys and Updates ON */
+	KEY_setState(1);
+	APP_setUpdateState(1);
+}
+
+uint8_t APP_retrace_open(uint16_t eid, uint8_t forward)
+{
+	/* Find Entry's First Page in Manifest */
+	NodePage * page = (NodePage *)disk.buff;
+	NodeRecord node;
+	ManifestEntry entry;
+	if(APP_manifest_get(eid,&entry) || entry.type != M_TRACE) return 1;
+	uint32_t sector = entry.start;
+	retrace.directory = entry.directory;
+	
+	/* Trace Opens With Its Origin Node (Absolute Fix) */
+	if(DISK_read(sector)) return 1;
+	if(page->magic != DAT_PAGE_MAGIC || page->eid != eid || page->count == 0) return 1;
+	APP_decode_node(page->body,&node);
+	if(node.type != D_ORIGINNODE) return 1;
+	retrace.originLon = node.x;
+	retrace.originLat = node.y;
+	
+	/* Going Back: Seek Straight to the Last Page a Closed Entry Recorded, Else Walk the Chain Once to It */
+	uint8_t walk = !forward;
+	if(walk && entry.closed)
+	{
+		if(entry.end == sector) walk = 0;
+		else if(DISK_read(entry.end)) return 1;
+		else if(page->magic == DAT_PAGE_MAGIC && page->eid == eid && page->count){
+			sector = entry.end;
+			walk = 0;
+		}
+		else if(DISK_read(sector)) return 1;						// Not its page: walk from the first
+	}
+	while(walk && page->next)
+	{
+		uint32_t next = page->next;
+		if(DISK_read(next)) return 1;
+		if(page->magic != DAT_PAGE_MAGIC || page->eid != eid || page->count == 0) break;
+		sector = next;
+	}
+	
+	/* Empty Read-Ahead, Nothing Staged */
+	retrace.sector = sector;
+	retrace.eid = eid;
+	retrace.forward = forward;
+	retrace.loaded = 0;
+	retrace.ended = 0;
+	retrace.seek = 0xFF;
+	retrace.probe = 0;
+	retrace.offRoute = 0;
+	retrace.probeCell.x = INT16_MAX;
+	retrace.from.type = 0xFF;
+	retrace.head = 0;
+	retrace.count = 0;
+	retrace.lastRot = 0xFF;
+	retrace.view.x = INT16_MAX;
+	return 0;
+}
+
+void APP_retrace_prefetch()
+{
+	/* Path Lost: Pick the Stream Up Again at an Indexed Node, If Any Is Near */
+	if(settings.mode == RETRACING && retrace.probe)
+	{
+		/* The Search Takes the Buffer: Restage the Page Where It Was Left */
+		IndexHit hits[RETRACE_HITS];
+		retrace.probe = 0;
+		if(retrace.loaded) retrace.seek = retrace.mark;
+		retrace.loaded = 0;
+		uint8_t found = APP_index_within(retrace.directory,retrace.live.x,retrace.live.y,RETRACE_OFFROUTE,hits,RETRACE_HITS);
+		if(!found){
+			if(!retrace.offRoute) retrace.offRoute = 1;
+			return;
+		}
+		
+		/* Nearest Node Still Ahead of the Stream (Records Are Addressed in Recording Order), Else the Nearest */
+		uint32_t at = DAT_ADDR(retrace.sector,0);
+		uint8_t pick = 0;
+		for(uint8_t i = 0; i < found; i++)
+			if(retrace.forward ? hits[i].addr >= at : hits[i].addr < at){ pick = i; break; }
+		retrace.sector = DAT_ADDR_SECTOR(hits[pick].addr);
+		retrace.seek = DAT_ADDR_INDEX(hits[pick].addr) + (retrace.forward ? 0 : 1);
+		retrace.ended = 0;
+		retrace.from.type = 0xFF;
+		retrace.head = 0;
+		retrace.count = 0;
+		retrace.view.x = INT16_MAX;
+		return;
+	}
+	
+	/* Only Work While Retracing With Room For a Block */
+	if(settings.mode != RETRACING || retrace.ended || retrace.count > RETRACE_AHEAD - RETRACE_BLOCK) return;
+	NodePage * page = (NodePage *)disk.buff;
+	
+	/* Stage Next Page (One Card Read Per Pass) */
+	if(!retrace.loaded)
+	{
+		if(DISK_read(retrace.sector) || page->magic != DAT_PAGE_MAGIC || page->eid != retrace.eid){
+			retrace.ended = 1;
+			return;
+		}
+		retrace.loaded = 1;
+		retrace.mark = retrace.forward ? 0 : page->count;
+		if(retrace.seek <= page->count) retrace.mark = retrace.seek;
+		retrace.seek = 0xFF;
+		return;
+	}
+	
+	/* Queue One Block of the Staged Page */
+	uint8_t n;
+	if(retrace.forward){
+		n = (page->count - retrace.mark < RETRACE_BLOCK) ? page->count - retrace.mark : RETRACE_BLOCK;
+		APP_retrace_queue(page,retrace.mark,n);
+		retrace.mark += n;
+	}
+	else{
+		n = (retrace.mark < RETRACE_BLOCK) ? retrace.mark : RETRACE_BLOCK;
+		retrace.mark -= n;
+		APP_retrace_queue(page,retrace.mark,n);
+	}
+	
+	/* Page Used Up: Move Along the Chain */
+	if(retrace.mark == (retrace.forward ? page->count : 0))
+	{
+		retrace.sector = retrace.forward ? page->next : page->prev;
+		retrace.loaded = 0;
+		if(!retrace.sector) retrace.ended = 1;
+	}
+}
+
+void APP_retrace_queue(const NodePage * page, uint8_t first, uint8_t n)
+{
+	/* Decode Records [first, first + n) Into Trace-Frame Positions */
+	RetraceNode block[RETRACE_BLOCK];
+	uint8_t found = 0;
+	const uint8_t * src = page->body;
+	NodeRecord node;
+	for(uint8_t i = 0; i < first + n; i++)
+	{
+		src = APP_decode_node(src,&node);
+		if(i < first) continue;
+		
+		/* Reference Nodes Hold an Absolute Fix Repeated By the Next Node: Skip */
+		RetraceNode * dst = &block[found];
+		switch(node.type){
+			case D_NORMALNODE:
+			case D_SUPERNODE:
+				dst->x = (int32_t)node.quad.x * (NAVSCREEN_MAP_PANEW * D2PX) - node.x;
+				dst->y = (int32_t)node.quad.y * (NAVSCREEN_MAP_PANEH * D2PX) - node.y;
+				break;
+			case D_ORIGINNODE:
+				dst->x = 0;
+				dst->y = 0;
+				break;
+			default:
+				continue;
+		}
+		dst->type = node.type;
+		found++;
+	}
+	
+	/* Append to Ring in Travel Order, Drawing Whatever Falls In View */
+	for(uint8_t i = 0; i < found; i++)
+	{
+		RetraceNode * dst = &shared.ring[(retrace.head + retrace.count++) % RETRACE_AHEAD];
+		*dst = block[retrace.forward ? i : found - 1 - i];
+		APP_retrace_draw(dst,NODECOLOR_NORMAL);
+	}
+}
+
+void APP_retrace_draw(const RetraceNode * node, Color color)
+{
+	/* Draw Node If It Lies In the Quadrant Shown */
+	int32_t dx = node->x - (int32_t)retrace.view.x * (NAVSCREEN_MAP_PANEW * D2PX);
+	int32_t dy = node->y - (int32_t)retrace.view.y * (NAVSCREEN_MAP_PANEH * D2PX);
+	if(dx < -MAPXBOUND || dx > MAPXBOUND || dy < -MAPYBOUND || dy > MAPYBOUND) return;
+	LCD_drawCircle_filled(NAVSCREEN_MAP_X0 + dx / D2PX, NAVSCREEN_MAP_Y0 - dy / D2PX,
+		node->type == D_NORMALNODE ? NODESIZE_S : NODESIZE, color);
+}
+
+void APP_update_retrace()
+{
+	/* Live Position in the Stored Trace's Frame */
+	RetraceNode live;
+	live.x = APP_FIX2POS(gps.LONGITUDE - retrace.originLon);
+	live.y = APP_FIX2POS(gps.LATITUDE - retrace.originLat);
+	live.type = D_NORMALNODE;
+	
+	/* Recentre Map Pane On the Quadrant Holding the Live Position */
+	Vector2 view;
+	view.x = (live.x + MAPXBOUND + (live.x < -MAPXBOUND ? 1 - NAVSCREEN_MAP_PANEW * D2PX : 0)) / (NAVSCREEN_MAP_PANEW * D2PX);
+	view.y = (live.y + MAPYBOUND + (live.y < -MAPYBOUND ? 1 - NAVSCREEN_MAP_PANEH * D2PX : 0)) / (NAVSCREEN_MAP_PANEH * D2PX);
+	if(view.x != retrace.view.x || view.y != retrace.view.y)
+	{
+		retrace.view = view;
+		LCD_drawRect_filled(NAVSCREEN_MAP_PANEX+1,NAVSCREEN_MAP_PANEY+1,NAVSCREEN_MAP_PANEW-2,NAVSCREEN_MAP_PANEH-2,NAVSCREEN_SCREENCOLOR);
+		for(uint8_t i = 0; i < retrace.count; i++)
+			APP_retrace_draw(&shared.ring[(retrace.head + i) % RETRACE_AHEAD],NODECOLOR_NORMAL);
+	}
+	APP_retrace_draw(&live,NODECOLOR_USER);
+	
+	/* Skip Ahead to the Nearest Queued Node (Corners May Be Cut), Then Past It Once Reached */
+	uint8_t nearest = 0;
+	uint32_t best = UINT32_MAX;
+	for(uint8_t i = 0; i < retrace.count; i++)
+	{
+		const RetraceNode * node = &shared.ring[(retrace.head + i) % RETRACE_AHEAD];
+		int32_t dx = node->x - live.x;
+		int32_t dy = node->y - live.y;
+		uint32_t d2 = (labs(dx) > 0x7FFF || labs(dy) > 0x7FFF) ? UINT32_MAX - 1 : (uint32_t)(dx * dx) + (uint32_t)(dy * dy);
+		if(d2 < best){ best = d2; nearest = i; }
+	}
+	if(retrace.count && best <= (uint32_t)RETRACE_REACH * RETRACE_REACH) nearest++;
+	if(nearest) retrace.from = shared.ring[(retrace.head + nearest - 1) % RETRACE_AHEAD];
+	retrace.head = (retrace.head + nearest) % RETRACE_AHEAD;
+	retrace.count -= nearest;
+	
+	/* On Route While Near the Path: From the Last Node Passed Through the Queued Ones */
+	uint8_t onRoute = 0;
+	const RetraceNode * from = (retrace.from.type != 0xFF) ? &retrace.from : 0;
+	for(uint8_t i = 0; i < retrace.count && !onRoute; i++)
+	{
+		const RetraceNode * node = &shared.ring[(retrace.head + i) % RETRACE_AHEAD];
+		onRoute = APP_retrace_near(from ? from : node,node,&live);
+		from = node;
+	}
+	
+	/* Strayed From the Queued Path: Have the Main Loop Search the Index, Once Per Cell Entered */
+	Vector2 cell;
+	cell.x = live.x >> RETRACE_CELL;
+	cell.y = live.y >> RETRACE_CELL;
+	if(retrace.count && !onRoute)
+	{
+		if(cell.x != retrace.probeCell.x || cell.y != retrace.probeCell.y){
+			retrace.probeCell = cell;
+			retrace.live = live;
+			retrace.probe = 1;
+		}
+	}
+	
+	/* Back On Route: Search Again Once Lost, Clear Alert */
+	else if(retrace.count)
+	{
+		retrace.probeCell.x = INT16_MAX;
+		if(retrace.offRoute == 2){
+			LCD_setText(NAVSCREEN_DIRB_TEXTX,TFTHEIGHT-18,NAVSCREEN_DIRB_SIZE,NODECOLOR_SUPER,NAVSCREEN_SCREENCOLOR);
+			LCD_print_str_P(PSTR("         "));
+		}
+		retrace.offRoute = 0;
+	}
+	
+	/* Nothing Indexed Nearby Either: Alert Once */
+	if(retrace.offRoute == 1)
+	{
+		retrace.offRoute = 2;
+		SFX_tone(FREQ_C4,150);
+		LCD_setText(NAVSCREEN_DIRB_TEXTX,TFTHEIGHT-18,NAVSCREEN_DIRB_SIZE,NODECOLOR_SUPER,NAVSCREEN_SCREENCOLOR);
+		LCD_print_str_P(PSTR("Off route"));
+	}
+	
+	/* Point DIRB At the Next Node */
+	if(retrace.count)
+	{
+		const RetraceNode * next = &shared.ring[retrace.head];
+		int16_t rot = APP_target2rot(next->x - live.x,next->y - live.y);
+		if(rot / 10 != retrace.lastRot){
+			retrace.lastRot = rot / 10;
+			LCD_drawArrow(NAVSCREEN_DIRB_TEXTX+40,NAVSCREEN_DIRB_TEXTY,rot,NODECOLOR_SUPER,NAVSCREEN_SCREENCOLOR);
+		}
+	}
+	
+	/* Whole Trace Followed */
+	else if(retrace.ended && retrace.lastRot != 0xFE)
+	{
+		retrace.lastRot = 0xFE;
+		LCD_drawRect_filled(NAVSCREEN_DIRB_TEXTX+40,NAVSCREEN_DIRB_TEXTY,29,29,NAVSCREEN_SCREENCOLOR);
+		LCD_setText(NAVSCREEN_DIRB_TEXTX,TFTHEIGHT-18,NAVSCREEN_DIRB_SIZE,NODECOLOR_SUPER,NAVSCREEN_SCREENCOLOR);
+		LCD_print_str_P(PSTR("Arrived"));
+	}
+}
+
+uint8_t APP_retrace_near(const RetraceNode * a, const RetraceNode * b, const RetraceNode * p)
+{
+	/* Near an End */
+	int32_t px = p->x - a->x, py = p->y - a->y;
+	int32_t qx = p->x - b->x, qy = p->y - b->y;
+	if(labs(px) > 0x3FFF || labs(py) > 0x3FFF) return 0;
+	if((uint32_t)(px * px + py * py) <= (uint32_t)RETRACE_OFFROUTE * RETRACE_OFFROUTE) return 1;
+	if(labs(qx) <= 0x3FFF && labs(qy) <= 0x3FFF
+	&& (uint32_t)(qx * qx + qy * qy) <= (uint32_t)RETRACE_OFFROUTE * RETRACE_OFFROUTE) return 1;
+	
+	/* Else Near the Segment Between: Projects Onto It, and |p x c| / |c| Within Reach */
+	int32_t cx = b->x - a->x, cy = b->y - a->y;
+	if(labs(cx) > 0x3FF || labs(cy) > 0x3FF) return 0;
+	uint32_t len2 = cx * cx + cy * cy;
+	int32_t dot = px * cx + py * cy;
+	if(len2 == 0 || dot < 0 || (uint32_t)dot > len2) return 0;
+	uint32_t cross = labs(px * cy - py * cx);
+	return cross <= 0xFFFF && cross * cross <= len2 * ((uint32_t)RETRACE_OFFROUTE * RETRACE_OFFROUTE);
+}
+
+int16_t APP_target2rot(int32_t dx, int32_t dy)
+{
+	/* Compass Bearing [deg], In the Arrow Rotation Used For Course (APP_course2rot) */
+	return (MATH_bearing(dx,dy) + 90) % 360;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//										  Debug Functions										  //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void APP_DGPS_setState(uint8_t state)
+{
+	if(state == 1 && !settings.isDGPSon)
+	{
+		/* Set All Characters To NULL By Default */
+		for(int i = 0; i < sizeof(gps); i++) *((char*)(&gps)+i) = 0;
+		
+		/* Set Default Status */
+		gps.STATUS = 'D';
+		
+		/* Enable DGPS */
+		settings.isDGPSon = 1;
+	}
+	
+	/* Else If State = 0, Disable DGPS */
+	else if(state == 0)	settings.isDGPSon = 0;
+}
+
+void APP_DGPS_setTime(uint8_t h, uint8_t m, uint8_t s)
+{
+	/* Set Time */
+	gps.UTC_TIME = h * 3600UL + m * 60 + s;
 }
 
 void APP_DGPS_setDate(uint8_t d, uint8_t m, uint8_t y)
 {
 	/* Set Date */
-	itoa(d, SYS_GPS.UTC_DATE_ASCII,     10);
-	itoa(m, SYS_GPS.UTC_DATE_ASCII + 3, 10);
-	itoa(y, SYS_GPS.UTC_DATE_ASCII + 6, 10);
+	gps.UTC_DATE = GPS_DATE_PACK(d,m,y);
 }
 
 void APP_DGPS_setLocation(int16_t lat, int16_t lon)
 {	
-	/* Set Position */
-	sprintf(SYS_GPS.LATITUDE_ASCII,"%-d",lat);
-	sprintf(SYS_GPS.LONGITUDE_ASCII,"%-d",lon);
-	
-	/* Set Direction */
-	SYS_GPS.NS = lat >= 0 ? 'N' : 'S';
-	SYS_GPS.EW = lon >= 0 ? 'E' : 'W';
+	/* Set Position (Map Units) */
+	gps.LATITUDE = APP_POS2FIX(lat);
+	gps.LONGITUDE = APP_POS2FIX(lon);
 }
 
 void APP_DGPS_setCourse(uint16_t course)
 {
-	/* Clear Data */
-	strcpy(SYS_GPS.COURSE_ASCII,"000");
-	
-	/* Set Data */
-	char tmp[GPS_BYTES_ASCII_COURSE];
-	itoa(course,tmp,10);
-	strcpy(SYS_GPS.COURSE_ASCII+(GPS_BYTES_ASCII_COURSE-strlen(tmp)-1),tmp);
+	/* Set Course */
+	gps.COURSE = course * GPS_COURSE_SCALE;
 }
 
 void APP_DGPS_incTime()
 {	
 	/* Increment Debug GPS Time */
-//	strcpy(SYS_GPS.UTC_TIME_ASCII_LAST,SYS_GPS.UTC_TIME_ASCII);
-	if(++SYS_GPS.UTC_TIME_ASCII[7] > '9' ){ SYS_GPS.UTC_TIME_ASCII[7] = '0';
-	if(++SYS_GPS.UTC_TIME_ASCII[6] > '5' ){ SYS_GPS.UTC_TIME_ASCII[6] = '0';
-	if(++SYS_GPS.UTC_TIME_ASCII[4] > '9' ){ SYS_GPS.UTC_TIME_ASCII[4] = '0';
-	if(++SYS_GPS.UTC_TIME_ASCII[3] > '5' ){ SYS_GPS.UTC_TIME_ASCII[3] = '0';
-	if(++SYS_GPS.UTC_TIME_ASCII[1] > '3' ){ SYS_GPS.UTC_TIME_ASCII[1] = '0';
-	if(++SYS_GPS.UTC_TIME_ASCII[0] > '2' ){ SYS_GPS.UTC_TIME_ASCII[0] = '0';
-	}}}}}}
+	gps.UTC_TIME = (gps.UTC_TIME + 1) % GPS_SECONDS_PER_DAY;
 }
 	
 void APP_setUpdateState(uint8_t state)
 {
 	/* Update Timer Interrupts: */
 	switch(state){
-		case 0: TIMSK0 &= ~(1<<OCIE0A);	return;
+		case 0: TIMSK0 &= ~(1<<OCIE0A);	updateDue = 0;	updatesOn = 0;	return;
 		case 1: 
+		updatesOn = 1;
 		TCNT0 = 0;
 		TIFR0 |= (1<<OCF0A);
 		TIMSK0 |= (1<<OCIE0A);	
@@ -109,6 +109,12 @@ void DISK_loadBuff_int(int data, uint8_t off)
 	disk.buffIt = off + strlen(disk.buff + off) + 1;
 }
 
+void DISK_loadBuff_long(int32_t data, uint8_t off)
+{
+	ltoa(data, disk.buff + off, 10);
+	disk.buffIt = off + strlen(disk.buff + off) + 1;
+}
+
 uint8_t DISK_write(uint32_t sector)
 {	
 	/* Convert Sector To Byte Address For Non-Block Card Types */
@@ -138,6 +144,77 @@ uint8_t DISK_read(uint32_t sector)
 	return 0;					// Return success
 }
 
+uint8_t DISK_read_part(uint32_t sector, uint16_t offset, uint8_t * dst, uint16_t len)
+{
+	/* Convert Sector To Byte Address For Non-Block Card Types */
+	if(disk.type != SDv2_BLOCK) sector *= 512;
+	
+	/* Perform Single-Block Read */					// ***
+	if(DISK_send_command(CMD17,sector)) return 1; 	//  Send 'Read Block' command
+	
+	/* Wait For Card To Ready Up */			// ***
+	uint8_t token;							// Declare token storage
+	do{										// Do the following:
+		token = DISK_spi_transmit(0xFF);	//  Receive data from card
+	} while(token == 0xFF);					//  While data is NOT a token
+	if(token != 0xFE) return 1;				// Return (from failure) if token is NOT SUCCESS
+	
+	/* Keep Bytes 'offset' Through 'offset + len - 1', Clocking Past the Rest and the CRC */
+	for(uint16_t i = 0; i < 512 + 2; i++){
+		uint8_t data = DISK_spi_transmit(0xFF);
+		if(i >= offset && i - offset < len) dst[i - offset] = data;
+	}
+	
+	/* Return From Success */	// ***
+	DISK_unassert();			// Unassert card to release SPI buses
+	return 0;					// Return success
+}
+
+uint8_t DISK_stream_open(uint32_t sector, uint16_t offset)
+{
+	/* Convert Sector To Byte Address For Non-Block Card Types */
+	if(disk.type != SDv2_BLOCK) sector *= 512;
+	
+	/* Perform Single-Block Read */					// ***
+	if(DISK_send_command(CMD17,sector)) return 1; 	//  Send 'Read Block' command
+	
+	/* Wait For Card To Ready Up */			// ***
+	uint8_t token;							// Declare token storage
+	do{										// Do the following:
+		token = DISK_spi_transmit(0xFF);	//  Receive data from card
+	} while(token == 0xFF);					//  While data is NOT a token
+	if(token != 0xFE){						// If token is NOT SUCCESS
+		DISK_unassert();					//  Unassert card
+		return 1;							//  Return (from failure)
+	}
+	
+	/* Clock Past the Bytes Before 'offset', Keeping the Card Selected */
+	for(uint16_t i = 0; i < offset; i++) DISK_spi_transmit(0xFF);
+	disk.streamLeft = 512 - offset;
+	return 0;
+}
+
+uint8_t DISK_stream_byte()
+{
+	/* Take the Next Byte, Clocking Past the CRC and Releasing the Card After the Block's Last */
+	uint8_t data = DISK_spi_transmit(0xFF);
+	if(--disk.streamLeft == 0){
+		DISK_spi_transmit(0xFF);
+		DISK_spi_transmit(0xFF);
+		DISK_unassert();
+	}
+	return data;
+}
+
+void DISK_stream_close()
+{
+	/* Clock Past the Rest of the Block and the CRC */
+	if(!disk.streamLeft) return;
+	for(uint16_t i = 0; i < disk.streamLeft + 2; i++) DISK_spi_transmit(0xFF);
+	disk.streamLeft = 0;
+	DISK_unassert();
+}
+
 uint8_t DISK_wipe(uint32_t sector, uint32_t count)
 {
 	/* Declare Fail Tracker */
@@ -233,6 +310,7 @@ uint8_t DISK_send_command(uint8_t cmd, uint32_t args)
 	/* Delare Control Parameters */	// ***
 	uint8_t res;					// Storage for received data
 	uint8_t count = 50;				// Timeout count			
+	DISK_stream_close();			// Finish a read left open first
 	
 	/* Send Special Command for ACMD<n> Type */	// ***
 	if(cmd & 0x80){								// If cmd[7] = 1 (cmd is ACMD<n> type),
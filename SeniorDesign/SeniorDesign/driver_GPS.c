@@ -44,6 +44,19 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #define BAUD 9600
 #define MY_UBBR FOSC/16/BAUD-1
+
+//Link rates tried by GPS_negotiate_baud(), fastest first. UBRR0 values assume U2X0 is set
+//(UBRR = FOSC/8/BAUD - 1):
+//	57600:	UBRR 16,	+2.1% error
+//	38400:	UBRR 25,	+0.2% error
+//	9600:	UBRR 103,	+0.2% error
+//115200 is not offered: its nearest divisors at 8 MHz are off by -3.5% and +8.5%.
+#define GPS_BAUD_COUNT		3
+#define GPS_BAUD_TARGET		0			//Rate we try to switch the receiver to
+#define GPS_BAUD_DEFAULT	2			//Receiver's factory rate
+#define GPS_REPLY_POLLS		30000		//RX polls (~10 us apart) to wait for a PMTK reply
+#define GPS_PROBE_TRIES		2			//Test packets sent per rate while probing
+#define GPS_ACK_EPOCHS		10			//Epochs to wait for a $PMTK001 before giving a command up
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //								GPS FIRMWARE COMMAND SEQUENCES									  //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -71,12 +84,38 @@
 #define RMC_MODE		69
 #define RMC_CHECKSUM	71
 
-#define parse_commas 10
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //								DRIVER SYSTEM VARIABLES											  //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 /* SYSTEM SPECIFIC STRUCTURE */
-	GPS_data SYS_GPS;				
+//Sentence commits update GPS_FIX field by field, and EPOCH is counted once every sentence of an
+//epoch has arrived. A single record is enough: the parser only runs inside GPS_service(), and
+//every reader (the subscribers and GPS_snapshot()) runs in the main loop too, never in an ISR, so
+//no reader can see a sentence half committed (e.g. a new latitude beside an old longitude).
+//GPS_service() stops draining once an epoch is complete, so the subscribers get it before the
+//next epoch's sentences are committed over it.
+	GPS_data GPS_FIX;
+
+/* FIX SUBSCRIBERS */
+//Each subscriber counts epochs and is called on every 'every'-th one (decimation):
+typedef struct{
+	GPS_handler handler;
+	uint8_t every;
+	uint8_t count;
+} GPS_subscriber;
+
+GPS_subscriber GPS_SUBS[GPS_SUBSCRIBER_MAX];
+uint8_t GPS_SUB_COUNT;
+uint8_t GPS_DELIVERED;					//EPOCH last handed to the subscribers
+
+/* OUTPUT RATE */
+uint8_t GPS_LINK;						//GPS_BAUD_TABLE index negotiated at start-up
+GPS_rate GPS_RATE;						//Rate last queued (GPS_RATE_COUNT until the first)
+
+/* TRANSMIT QUEUE */
+//Filled by GPS_queue_P() and emptied by ISR(USART0_UDRE_vect), so sending a command costs the
+//main loop nothing but the enqueue. Replies are matched back to it by the $PMTK001 parser.
+GPS_tx_queue GPS_TX;
 					
 /* MONTH POINTERS */
 //const char * MONTH_TABLE[12] PROGMEM = {"January  ",
@@ -92,15 +131,65 @@
 										//"November ",
 										//"December "	};		//Default string length is 9 bytes
 								
-/* LINEAR BUFFER */
-//This is used to store data transactions from the UART port, whenever a '$' character
-//is detected in the UDR0 register. After detection, serial storage of data will begin,
-//until the checksum is evaluated, whereupon the system will flush the buffer and wait
-//for another '$'
-unsigned char GPS_BUFFER[GPS_BUFFER_MAX];			//A byte-address length buffer 
-													//				{Max address: 0xFF, or 255}
-unsigned char GPS_BUFFER_INDEX = 0;
-unsigned char GPS_MESSAGE_READY = 0;
+/* STREAMING PARSER */
+//NMEA sentences are decoded one byte at a time as they leave GPS_RX. Digits are accumulated
+//straight into binary, so no copy of the sentence is kept. The decoded RMC fields are held here,
+//already in the fixed-point units of GPS_data, until the end of the sentence, and only then
+//committed to GPS_FIX.
+#define GPS_FRAC_MAX		4			//Fraction digits kept for any field (ddmm.mmmm)
+#define GPS_FIELD_MAXLEN	12			//Characters accumulated per field before digits are ignored
+#define GPS_TIMEZONE_SHIFT	5			//Hours subtracted from UTC for display (EST)
+
+typedef enum{
+	GPS_ST_IDLE,						//Waiting for '$'
+	GPS_ST_FIELD,						//Inside a ',' separated field
+	GPS_ST_CHECKSUM						//'*' seen, reading the two hex checksum digits
+} GPS_parse_state;
+
+typedef struct{
+	GPS_parse_state state;
+	uint8_t field;						//Field index (0 = sentence ID)
+	uint8_t len;						//Characters seen in current field
+	uint8_t sum;						//Running XOR of all characters between '$' and '*'
+	int8_t frac;						//Digits seen after '.' in current field (-1 = no '.')
+	char first;							//First character of current field
+	uint32_t acc;						//Digits of current field (or of the checksum)
+	
+	/* Sentence Selection */
+	uint8_t candidates;					//NMEA_TABLE entries still matching the ID (bit per entry)
+	uint8_t sentence;					//Matched GPS_NMEA_* entry
+	uint8_t seen;						//Sentences published since the last update request
+	
+	/* Command Acknowledgment ($PMTK001) */
+	uint16_t ackId;						//PMTK packet type being acknowledged
+	uint8_t ackFlag;					//GPS_ack result
+	
+	/* Decoded Fields (Shared Between Sentence Types) */
+	uint32_t time;						//Hundredths of a second of day
+	uint16_t date;						//GPS_DATE_PACK(dd,mm,yy)
+	int32_t lat;						//[1e-7 deg], unsigned until hemisphere is applied
+	int32_t lon;						//[1e-7 deg], unsigned until hemisphere is applied
+	uint16_t speed;						//[cm/s]
+	uint16_t course;					//[0.01 deg]
+	uint16_t hdop;						//[0.01]
+	int32_t altitude;					//[cm]
+	uint8_t quality;
+	uint8_t satellites;
+	uint8_t fixType;
+	char status;
+	char ns;
+	char ew;
+} GPS_parser;
+
+GPS_parser GPS_PARSE;
+
+/* RECEIVE RING */
+//Filled by ISR(USART0_RX_vect) and drained by GPS_service() from the main loop. The ISR does
+//nothing but enqueue, so a long parse or screen update can no longer hold off the receiver.
+GPS_ring GPS_RX;
+
+/* SENTENCE COUNTERS */
+GPS_counters GPS_STATS;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //								DRIVER FUNCTION SET/PROTOTYPES									  //
@@ -152,20 +241,89 @@ char GPS_receive_byte(void);
 void GPS_flush_buffer(void);
 void GPS_parse_data(void);
 void GPS_TX_PARSE_ERROR(void);
+void GPS_send_P(const unsigned char * cmd);
+void GPS_set_baud(uint8_t index);
+uint8_t GPS_await_P(const unsigned char * reply);
+uint8_t GPS_probe_baud(uint8_t index);
+uint8_t GPS_find_baud(void);
+uint8_t GPS_negotiate_baud(void);
+uint16_t GPS_cmd_id(const unsigned char * cmd);
+void GPS_ack_retire(GPS_ack result);
+void GPS_ack_match(void);
+void GPS_ack_age(void);
+void GPS_rate_done(uint16_t id, GPS_ack result);
 //10-20-2018
-void GPS_request_update(void);				//Allows the GPS to obtain an update.
-uint8_t GPS_parse_V3(void);					//Newest, and critically important.
-											//Has a vital return type: {0 = FAIL, 1 = VALID}
+void GPS_service(void);						//Drains GPS_RX and parses, called from the main loop.
+void GPS_deliver(void);						//Hands new fixes to the subscribers.
+void GPS_parse_byte(char data);				//Streaming NMEA parser, fed one byte at a time.
+void GPS_parse_id(char data);
+void GPS_parse_char(char data);
+void GPS_parse_checksum(char data);
+void GPS_parse_endField(void);
+void GPS_parse_commit(void);
+void GPS_publish(void);
+uint32_t GPS_parse_scale(uint8_t fracDigits);
+int32_t GPS_parse_coord(void);
+uint32_t GPS_parse_time(void);
+uint16_t GPS_parse_knots(void);
+void GPS_field_RMC(uint8_t field);
+void GPS_field_GGA(uint8_t field);
+void GPS_field_GSA(uint8_t field);
+void GPS_field_VTG(uint8_t field);
+void GPS_field_ACK(uint8_t field);
+void GPS_commit_RMC(void);
+void GPS_commit_GGA(void);
+void GPS_commit_GSA(void);
+void GPS_commit_VTG(void);
+void GPS_commit_ACK(void);
+char * GPS_put_uint(char * dst, uint32_t val, uint8_t width);
 
 /* FIRMWARE COMMANDS */
 //Or at least the ones we care about:
 // turn on only the second sentence (GPRMC)
 const unsigned char FIRM_RMC[51] PROGMEM=			"$PMTK314,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0*29\r\n";
-const unsigned char FIRM_BAUD[18] PROGMEM=			"$PMTK251,9600*17\r\n";
+// turn on the second and fourth sentences (GPRMC + GPGGA)
+const unsigned char FIRM_RMC_GGA[] PROGMEM=			"$PMTK314,0,1,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0*28\r\n";
+const unsigned char FIRM_BAUD[] PROGMEM=			"$PMTK251,9600*17\r\n";
+const unsigned char FIRM_BAUD_38400[] PROGMEM=		"$PMTK251,38400*27\r\n";
+const unsigned char FIRM_BAUD_57600[] PROGMEM=		"$PMTK251,57600*2C\r\n";
 const unsigned char FIRM_ECHO_1HZ[18] PROGMEM=		"$PMTK220,1000*1F\r\n";
-const unsigned char FIRM_ECHO_10HZ[17] PROGMEM=		"$PMTK220,100*2F\r\n";
-const unsigned char FIRM_FIX_1HZ[26] PROGMEM=		"$PMTK300,1000,0,0,0,0*1C\r\n";
-const unsigned char FIRM_FIX_5HZ[25] PROGMEM=		"$PMTK300,200,0,0,0,0*2F\r\n";
+const unsigned char FIRM_ECHO_5HZ[] PROGMEM=		"$PMTK220,200*2C\r\n";
+const unsigned char FIRM_ECHO_10HZ[] PROGMEM=		"$PMTK220,100*2F\r\n";
+// test packet, and the acknowledgment it always gets back
+const unsigned char FIRM_TEST[] PROGMEM=			"$PMTK000*32\r\n";
+const unsigned char FIRM_TEST_ACK[] PROGMEM=		"$PMTK001,0,3";
+const unsigned char FIRM_FIX_1HZ[] PROGMEM=		"$PMTK300,1000,0,0,0,0*1C\r\n";
+const unsigned char FIRM_FIX_5HZ[] PROGMEM=		"$PMTK300,200,0,0,0,0*2F\r\n";
+
+/* BAUD RATE TABLE */
+//Indexed as described under BAUD RATE CONFIGURATION. Each rate carries the fastest output it can
+//sustain: RMC+GGA is ~150 bytes per epoch, so 10 Hz needs ~1500 B/s and only fits the fast rates.
+typedef struct{
+	uint8_t ubrr;							//UBRR0 with U2X0 set
+	const unsigned char * setBaud;			//PMTK251 selecting this rate
+	uint8_t maxRate;						//Fastest GPS_rate this rate carries
+} GPS_baud;
+
+const GPS_baud GPS_BAUD_TABLE[GPS_BAUD_COUNT] PROGMEM = {
+	{16,	FIRM_BAUD_57600,	GPS_RATE_10HZ},			//57600: 10 Hz, ~26% of the line
+	{25,	FIRM_BAUD_38400,	GPS_RATE_10HZ},			//38400: 10 Hz, ~39% of the line
+	{103,	FIRM_BAUD,			GPS_RATE_1HZ}			//9600:   1 Hz, ~16% of the line (5 Hz is ~78%)
+};
+
+/* OUTPUT RATE TABLE */
+//Indexed by GPS_rate. The MTK engine computes at most 5 fixes per second, so 10 Hz output runs on
+//the 5 Hz fix interval (every other epoch repeats the position with a new time).
+typedef struct{
+	const unsigned char * setFix;			//PMTK300 position fix interval
+	const unsigned char * setEcho;			//PMTK220 NMEA output period
+} GPS_output;
+
+const GPS_output GPS_RATE_TABLE[GPS_RATE_COUNT] PROGMEM = {
+	{FIRM_FIX_1HZ,	FIRM_ECHO_1HZ},
+	{FIRM_FIX_5HZ,	FIRM_ECHO_5HZ},
+	{FIRM_FIX_5HZ,	FIRM_ECHO_10HZ}
+};
 
 /* BUILT-IN MESSAGES */
 //These messages always contain their length as the first character:
@@ -173,266 +331,918 @@ const unsigned char MSG_DATA_ERROR[15] PROGMEM =			"DATA NOT VALID!";
 const unsigned char MSG_REPORT_UTC[7] PROGMEM =				"[UTC] ";
 const unsigned char MSG_GPRMC_NOT_RECEIVED[20] PROGMEM =	"GPRMC NOT AVAILABLE!";
 
+/* SENTENCE DISPATCH TABLE */
+//Sentences are selected by their whole ID. A '?' stands for the talker letter after the 'G' ("GP",
+//"GN" or "GL"), and IDs shorter than GPS_ID_MAX end with a NUL. Each entry names the last field
+//that must be present, the handler that stores a closed field, and the commit that publishes the
+//sentence once its checksum has been verified.
+#define GPS_ID_MAX			7			//Longest sentence ID ("PMTK001")
+
+typedef struct{
+	char id[GPS_ID_MAX];
+	uint8_t lastField;
+	void (*field)(uint8_t field);
+	void (*commit)(void);
+} GPS_dispatch;
+
+const GPS_dispatch NMEA_TABLE[GPS_NMEA_COUNT] PROGMEM = {
+	{"G?RMC",		9,	GPS_field_RMC,	GPS_commit_RMC},		//GPS_NMEA_RMC
+	{"G?GGA",		9,	GPS_field_GGA,	GPS_commit_GGA},		//GPS_NMEA_GGA
+	{"G?GSA",		17,	GPS_field_GSA,	GPS_commit_GSA},		//GPS_NMEA_GSA
+	{"G?VTG",		8,	GPS_field_VTG,	GPS_commit_VTG},		//GPS_NMEA_VTG
+	{"PMTK001",		2,	GPS_field_ACK,	GPS_commit_ACK}			//GPS_NMEA_ACK
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 /*
-	FUNCTION:		void GPS_parse_V3(void);
+	FUNCTION:		void GPS_parse_byte(char data);
 	AUTHOR:			Christopher DeFranco
 	
-	DESCRIPTION:	This function is called at the end of an update request. The new parser does
-					not automatically perform the math necessary to compress the SRAM space, but
-					instead simply stores characters serially into their buffers. 
+	DESCRIPTION:	Incremental NMEA parser. Each received byte advances a small state machine
+					instead of being buffered for a multi-pass parse once the sentence ends:
 					
-					',' characters are used to determine what sequence of the parse you are within,
-					since it was discovered that the NMEA GPRMC sentences do not have a finite
-					length. Data validity status must also be checked to determine what is going
-					on.
+						'$'		Starts a new sentence (from any state).
+						','		Ends the current field, which is handed to the field handler
+								of the sentence type in NMEA_TABLE.
+						'*'		Ends the last field. The next two characters are the hex
+								checksum, and the sentence is only committed to GPS_FIX if
+								it matches the XOR accumulated on the way in.
+						other	Folded into the XOR checksum and the field accumulator.
 					
-					This function begins by disabling the stream, and ends by flushing the buffer,
-					and reseting the interrupt-parser variable GPS_MESSAGE_READY = 0;
+					The sentence ID is checked as its characters arrive, so sentences that are not
+					in NMEA_TABLE are abandoned as soon as they stop matching.
 	
 */
-uint8_t GPS_parse_V3(void){
+void GPS_parse_byte(char data){
 	
-	//Disable the stream:
-	GPS_disable_stream();
-	//Reset the MESSAGE_READY conditional variable:
-	GPS_MESSAGE_READY = 0;
+	//A '$' always starts a new sentence, even in the middle of a broken one:
+	if(data == '$'){
+		GPS_PARSE.state = GPS_ST_FIELD;
+		GPS_PARSE.field = 0;
+		GPS_PARSE.len = 0;
+		GPS_PARSE.sum = 0;
+		GPS_PARSE.candidates = (1 << GPS_NMEA_COUNT) - 1;
+		return;
+	}
+	
+	if(GPS_PARSE.state == GPS_ST_CHECKSUM){
+		GPS_parse_checksum(data);
+		return;
+	}
+	if(GPS_PARSE.state != GPS_ST_FIELD) return;
 	
-	//Enable interrupts for other systems:
-	sei();
+	//The checksum trails the '*', so the last field is complete here:
+	if(data == '*'){
+		GPS_parse_endField();
+		if(GPS_PARSE.state == GPS_ST_IDLE) return;
+		GPS_PARSE.state = GPS_ST_CHECKSUM;
+		GPS_PARSE.len = 0;
+		GPS_PARSE.acc = 0;
+		return;
+	}
 	
-	//Begin the actual parsing:
-	//When looping, the maximum comma count we are interested in for GPRMC NMEA is (10). 
+	GPS_PARSE.sum ^= data;
 	
-	for(uint8_t comma = 0; comma < parse_commas; comma++){
-		
-		//Use an internal byte counter for SYS_GPS array placement.
-		uint8_t byte = 0;
-		uint8_t stop = 0;
-		
-		switch(comma){
-			case 0:		//Message ID (GPRMC)	|	5	|	GPRMC			|
-						//Place buffer index at the beginning of the GPRMC sentence:
-						GPS_BUFFER_INDEX = 1;
-						//Check to see if the next 5 bytes are GPRMC, or break the loop:
-						if(	(GPS_BUFFER[GPS_BUFFER_INDEX	] == 'G')&&
-							(GPS_BUFFER[GPS_BUFFER_INDEX + 1] == 'P')&&
-							(GPS_BUFFER[GPS_BUFFER_INDEX + 2] == 'R')&&
-							(GPS_BUFFER[GPS_BUFFER_INDEX + 3] == 'M')&&
-							(GPS_BUFFER[GPS_BUFFER_INDEX + 4] == 'C') )
-							{GPS_BUFFER_INDEX += 6; break;}
-						//If the sentence wasn't detected, force-break the switch and loop:
-						else{	SYS_GPS.IS_PROCESSING = 0;
-								return 1;}
-						
-			case 1:		//UTC Time				|	10	|	hhmmss.sss		|
-						//While you have not reached ',' store the subsequent bits in SYS.GPS:
-						while(GPS_BUFFER[GPS_BUFFER_INDEX] != ','){
-							if(byte < GPS_BYTES_ASCII_UTC_TIME){
-								if(byte==2||byte==5) byte++;
-								SYS_GPS.UTC_TIME_ASCII[byte] = GPS_BUFFER[GPS_BUFFER_INDEX];
-								byte++;
-							}
-							GPS_BUFFER_INDEX++;
-						}
-						//The ',' character was detected, so jump over it.
-						GPS_BUFFER_INDEX++;
-						int8_t timeCorrection = atoi(SYS_GPS.UTC_TIME_ASCII) - 5;
-						if(timeCorrection<0) timeCorrection+= 24;
-						itoa(timeCorrection,SYS_GPS.UTC_TIME_ASCII+(timeCorrection>9?0:1),10);
-						SYS_GPS.UTC_TIME_ASCII[2] = ':';
-						//comma++;
-						break;
-
-			case 2:		//Data Status			|	1	|	A				|
-						//This data is always available, and tells us whether or not any real data is present:
-						if(GPS_BUFFER[GPS_BUFFER_INDEX] == 'A'){
-							SYS_GPS.STATUS = 'A';
-							GPS_BUFFER_INDEX += 2; 
-							break;
-						}
-						//Force-terminate the parse. 
-						//Send the error flag.
-						else{	
-							SYS_GPS.IS_PROCESSING = 0;
-							SYS_GPS.STATUS = 'V';
-							return 1;
-						} 
-							
-			case 3:		//Latitude				|	9	|	ddmm.mmmm		|
-						//While you have not reached ',' store the subsequent bits in SYS.GPS:
-						while(GPS_BUFFER[GPS_BUFFER_INDEX] != ','){
-							//Write directly into the system:
-							if(GPS_BUFFER[GPS_BUFFER_INDEX] == '.') GPS_BUFFER_INDEX++;
-							SYS_GPS.LATITUDE_ASCII[byte] = GPS_BUFFER[GPS_BUFFER_INDEX];
-							//Increment buffer and byte counter:
-							GPS_BUFFER_INDEX++;
-							byte++;
-						}
-						//Finalize by increasing counts and hopping over the comma:
-						GPS_BUFFER_INDEX++;
-						
-						break;
-
-			case 4:		//N/S					|	1	|	N				|				
-						SYS_GPS.NS = GPS_BUFFER[GPS_BUFFER_INDEX];
-						// Add '-' character for southern bound latitude
-						if(SYS_GPS.NS == 'S'){
-							for(int i = GPS_BYTES_ASCII_LATITUDE-2; i > 0; i--) SYS_GPS.LATITUDE_ASCII[i] = SYS_GPS.LATITUDE_ASCII[i-1];
-							SYS_GPS.LATITUDE_ASCII[0] = '-';
-						}
-
-						//Hop over the ","
-						GPS_BUFFER_INDEX += 2;
-						//Increment count:
-							
-						//Break:
-						break;
-						
-						
-			case 5:		//Longitude				|	10	|	12016.4438		|
-						//While you have not reached ',' store the subsequent bits in SYS.GPS:
-						while(GPS_BUFFER[GPS_BUFFER_INDEX] != ','){
-							if(GPS_BUFFER[GPS_BUFFER_INDEX] == '.') GPS_BUFFER_INDEX++;
-							//Write directly into the system:
-							SYS_GPS.LONGITUDE_ASCII[byte] = GPS_BUFFER[GPS_BUFFER_INDEX];
-							//Increment buffer and byte counter:
-							GPS_BUFFER_INDEX++;
-							byte++;
-						}
-						
-						GPS_BUFFER_INDEX++;
-						break;
-						
-			case 6:		//E/W					|	1	|	E				|
-						SYS_GPS.EW = GPS_BUFFER[GPS_BUFFER_INDEX];
-						if(SYS_GPS.EW == 'W'){
-							for(int i = GPS_BYTES_ASCII_LONGITUDE-2; i > 0; i--) SYS_GPS.LONGITUDE_ASCII[i] = SYS_GPS.LONGITUDE_ASCII[i-1];
-							SYS_GPS.LONGITUDE_ASCII[0] = '-';
-						}
-						GPS_BUFFER_INDEX += 2;
-							
-						break;
-						
-			case 7:		//Speed					|	4	|	0.03			|
-						while(GPS_BUFFER[GPS_BUFFER_INDEX] != ','){
-							if(GPS_BUFFER[GPS_BUFFER_INDEX] == '.') stop = 1;
-							if(!stop){
-								SYS_GPS.SPEED_ASCII[byte] = GPS_BUFFER[GPS_BUFFER_INDEX];
-								byte++;
-							}
-							GPS_BUFFER_INDEX++;
-						} 
-						GPS_BUFFER_INDEX++;
-						break;
-						
-			case 8:		//Course				|	4-5	|	165.03 OR 43.45	|
-						while(GPS_BUFFER[GPS_BUFFER_INDEX] != ','){
-							if(GPS_BUFFER[GPS_BUFFER_INDEX] == '.') stop = 1;
-							if(!stop){
-								SYS_GPS.COURSE_ASCII[byte] = GPS_BUFFER[GPS_BUFFER_INDEX];
-								byte++;
-							}
-							GPS_BUFFER_INDEX++;
-						}
-						GPS_BUFFER_INDEX++;
-						break;
-		
-			case 9:		//Date					|	6	|	ddmmyy			|
-						//While you have not reached ',' store the subsequent bits in SYS.GPS:
-						while(GPS_BUFFER[GPS_BUFFER_INDEX] != ','){
-							if(byte < GPS_BYTES_ASCII_UTC_DATE){
-								if(byte==2||byte==5) byte++;
-								SYS_GPS.UTC_DATE_ASCII[byte] = GPS_BUFFER[GPS_BUFFER_INDEX];
-								byte++;
-							}
-							GPS_BUFFER_INDEX++;
-						}
+	if(data == ','){
+		GPS_parse_endField();
+		GPS_PARSE.field++;
+		GPS_PARSE.len = 0;
+	}
+	else if(GPS_PARSE.field == 0) GPS_parse_id(data);
+	else GPS_parse_char(data);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_parse_id(char data);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Matches a character of the sentence ID, narrowing the set of NMEA_TABLE
+					entries still matching. A talker ('?' in the table) must be GP (GPS), GN
+					(multi-GNSS) or GL (GLONASS). The sentence is abandoned as soon as no entry is
+					left.
+	
+*/
+void GPS_parse_id(char data){
+	
+	uint8_t pos = GPS_PARSE.len++;
+	
+	if(pos < GPS_ID_MAX){
+		for(uint8_t i = 0; i < GPS_NMEA_COUNT; i++){
+			char id = pgm_read_byte(&NMEA_TABLE[i].id[pos]);
+			uint8_t match = (id == '?') ? (data == 'P' || data == 'N' || data == 'L') : (id == data);
+			if(!match) GPS_PARSE.candidates &= ~(1 << i);
 		}
+		if(GPS_PARSE.candidates) return;
 	}
-
-
-	//After the for loop, figure out what variables need to be reset and whatnot.
-	SYS_GPS.IS_PROCESSING = 0;
-	GPS_MESSAGE_READY = 0;
-	GPS_BUFFER_INDEX = 0;
+	
+	GPS_PARSE.state = GPS_ST_IDLE;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_parse_char(char data);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Handles a character inside a data field. Every field keeps its first character
+					(status/hemisphere/sign flags) and accumulates its digits, up to GPS_FRAC_MAX
+					digits past the '.'.
+	
+*/
+void GPS_parse_char(char data){
+	
+	//First character of a data field resets the accumulator:
+	if(GPS_PARSE.len == 0){
+		GPS_PARSE.first = data;
+		GPS_PARSE.acc = 0;
+		GPS_PARSE.frac = -1;
+	}
+	if(GPS_PARSE.len < GPS_FIELD_MAXLEN) GPS_PARSE.len++;
+	else return;
+	
+	if(data == '.'){
+		GPS_PARSE.frac = 0;
+	}
+	else if(data >= '0' && data <= '9' && GPS_PARSE.frac < GPS_FRAC_MAX){
+		GPS_PARSE.acc = GPS_PARSE.acc * 10 + (data - '0');
+		if(GPS_PARSE.frac >= 0) GPS_PARSE.frac++;
+	}
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_parse_checksum(char data);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Collects the two hex digits after '*' and compares them with the running XOR.
+					A matching sentence is committed; a mismatch or a non-hex character discards
+					it, so a corrupted byte never reaches GPS_FIX (or the card).
+	
+*/
+void GPS_parse_checksum(char data){
+	
+	uint8_t nibble;
+	if(data >= '0' && data <= '9')		nibble = data - '0';
+	else if(data >= 'A' && data <= 'F')	nibble = data - 'A' + 10;
+	else if(data >= 'a' && data <= 'f')	nibble = data - 'a' + 10;
+	else{
+		GPS_STATS.bad++;
+		GPS_PARSE.state = GPS_ST_IDLE;
+		return;
+	}
+	
+	GPS_PARSE.acc = (GPS_PARSE.acc << 4) | nibble;
+	if(++GPS_PARSE.len < 2) return;
+	
+	GPS_PARSE.state = GPS_ST_IDLE;
+	if(GPS_PARSE.acc != GPS_PARSE.sum){
+		GPS_STATS.bad++;
+		return;
+	}
+	
+	GPS_STATS.good++;
+	GPS_parse_commit();
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		uint32_t GPS_parse_scale(uint8_t fracDigits);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Returns the current field's accumulator with exactly 'fracDigits' digits after
+					the decimal point (truncating or zero-padding as necessary).
+	
+*/
+uint32_t GPS_parse_scale(uint8_t fracDigits){
+	
+	uint32_t val = GPS_PARSE.acc;
+	int8_t frac = GPS_PARSE.frac < 0 ? 0 : GPS_PARSE.frac;
+	
+	for(; frac < fracDigits; frac++) val *= 10;
+	for(; frac > fracDigits; frac--) val /= 10;
+	return val;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		int32_t GPS_parse_coord(void);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Converts the current (d)ddmm.mmmm field into [1e-7 deg]. One 1e-4 minute step
+					is 1e7 / 600000 = 50/3 units.
+	
+*/
+int32_t GPS_parse_coord(void){
+	
+	uint32_t val = GPS_parse_scale(GPS_FRAC_MAX);			// (d)ddmmmmmm
+	uint32_t deg = val / 1000000;
+	uint32_t minutes = val % 1000000;						// mmmmmm [1e-4 min]
+	
+	return deg * GPS_COORD_SCALE + (minutes * 50 + 1) / 3;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		uint32_t GPS_parse_time(void);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Converts the current hhmmss(.sss) field into hundredths of a second of day
+					(fixes at 5 and 10 Hz share their second).
+	
+*/
+uint32_t GPS_parse_time(void){
+	
+	uint32_t val = GPS_parse_scale(2);
+	uint32_t sec = val / 100;
+	return ((sec / 10000) * 3600UL + ((sec / 100) % 100) * 60 + sec % 100) * 100 + val % 100;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		uint16_t GPS_parse_knots(void);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Converts the current speed field from knots into [cm/s]
+					(1 kn = 51.444 cm/s = 1286/25 [0.01 kn]).
+	
+*/
+uint16_t GPS_parse_knots(void){
+	
+	return (GPS_parse_scale(2) * 1286 + 1250) / 2500;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_parse_endField(void);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Closes the field ended by ',' or '*'. The sentence ID selects the NMEA_TABLE
+					entry; every later field is passed to that entry's field handler.
+	
+*/
+void GPS_parse_endField(void){
+	
+	//Sentence ID must have ended exactly where a remaining entry's ID does:
+	if(GPS_PARSE.field == 0){
+		for(uint8_t i = 0; i < GPS_NMEA_COUNT; i++){
+			if(!(GPS_PARSE.candidates & (1 << i))) continue;
+			if(GPS_PARSE.len == GPS_ID_MAX || !pgm_read_byte(&NMEA_TABLE[i].id[GPS_PARSE.len])){
+				GPS_PARSE.sentence = i;
+				return;
+			}
+		}
+		GPS_PARSE.state = GPS_ST_IDLE;
+		return;
+	}
+	
+	//Empty fields decode as zero:
+	if(GPS_PARSE.len == 0){
+		GPS_PARSE.first = 0;
+		GPS_PARSE.acc = 0;
+		GPS_PARSE.frac = -1;
+	}
+	
+	void (*handler)(uint8_t) = pgm_read_ptr(&NMEA_TABLE[GPS_PARSE.sentence].field);
+	handler(GPS_PARSE.field);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_parse_commit(void);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Publishes a verified sentence through its NMEA_TABLE commit. Sentences missing
+					fields are ignored. The fix is published once every sentence type in
+					GPS_NMEA_EPOCH has been committed.
+	
+*/
+void GPS_parse_commit(void){
+	
+	//Ignore truncated sentences:
+	if(GPS_PARSE.field < pgm_read_byte(&NMEA_TABLE[GPS_PARSE.sentence].lastField)) return;
+	
+	void (*commit)(void) = pgm_read_ptr(&NMEA_TABLE[GPS_PARSE.sentence].commit);
+	commit();
+	
+	//Publish a complete epoch:
+	GPS_PARSE.seen |= 1 << GPS_PARSE.sentence;
+	if((GPS_PARSE.seen & GPS_NMEA_EPOCH) == GPS_NMEA_EPOCH){
+		GPS_PARSE.seen = 0;
+		GPS_publish();
+	}
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_publish(void);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Marks the sentences committed to GPS_FIX so far as a complete fix by moving
+					its EPOCH on. Called from the parser, so only ever from GPS_service().
+	
+*/
+void GPS_publish(void){
+	
+	GPS_FIX.EPOCH++;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		uint8_t GPS_snapshot(GPS_data * dst);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Copies the fix into 'dst' and returns its EPOCH. Main loop only, like the
+					parser that writes it (see GPS_FIX): between GPS_service() calls every sentence
+					is either committed in full or not at all.
+	
+*/
+uint8_t GPS_snapshot(GPS_data * dst){
+	
+	*dst = GPS_FIX;
+	
+	return dst->EPOCH;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_field_RMC(uint8_t field);
+					void GPS_commit_RMC(void);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Recommended minimum data:
+					
+					1 UTC Time	| 2 Status	| 3 Latitude	| 4 N/S		| 5 Longitude
+					6 E/W		| 7 Speed	| 8 Course		| 9 Date
+					
+					Time and date are always published; position, speed and course only when the
+					data status is 'A'.
+	
+*/
+void GPS_field_RMC(uint8_t field){
+	
+	uint32_t val;
+	switch(field){
+		case 1:	GPS_PARSE.time = GPS_parse_time();					break;
+		case 2:	GPS_PARSE.status = GPS_PARSE.first;					break;
+		case 3:	GPS_PARSE.lat = GPS_parse_coord();					break;
+		case 4:	GPS_PARSE.ns = GPS_PARSE.first;						break;
+		case 5:	GPS_PARSE.lon = GPS_parse_coord();					break;
+		case 6:	GPS_PARSE.ew = GPS_PARSE.first;						break;
+		case 7:	GPS_PARSE.speed = GPS_parse_knots();				break;
+		case 8:	GPS_PARSE.course = GPS_parse_scale(2);				break;
+		case 9:	//ddmmyy -> packed
+				val = GPS_parse_scale(0);
+				GPS_PARSE.date = GPS_DATE_PACK(val / 10000, (val / 100) % 100, val % 100);
+				break;
+		default: ;
+	}
+}
+void GPS_commit_RMC(void){
+	
+	//Time and date:
+	GPS_FIX.UTC_TIME = GPS_PARSE.time / 100;
+	GPS_FIX.UTC_CENTI = GPS_PARSE.time % 100;
+	GPS_FIX.UTC_DATE = GPS_PARSE.date;
+	
+	//Position, speed and course are only meaningful with a fix:
+	if(GPS_PARSE.status == 'A'){
+		GPS_FIX.LATITUDE = GPS_PARSE.ns == 'S' ? -GPS_PARSE.lat : GPS_PARSE.lat;
+		GPS_FIX.LONGITUDE = GPS_PARSE.ew == 'W' ? -GPS_PARSE.lon : GPS_PARSE.lon;
+		GPS_FIX.SPEED = GPS_PARSE.speed;
+		GPS_FIX.COURSE = GPS_PARSE.course;
+	}
+	
+	GPS_FIX.STATUS = GPS_PARSE.status == 'A' ? 'A' : 'V';
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_field_GGA(uint8_t field);
+					void GPS_commit_GGA(void);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Fix data:
+					
+					1 UTC Time	| 2 Latitude	| 3 N/S			| 4 Longitude	| 5 E/W
+					6 Quality	| 7 Satellites	| 8 HDOP		| 9 Altitude (MSL)
+					
+					Quality, satellite count, HDOP and altitude are always published; position
+					only when the quality reports a fix.
+	
+*/
+void GPS_field_GGA(uint8_t field){
+	
+	switch(field){
+		case 1:	GPS_PARSE.time = GPS_parse_time();					break;
+		case 2:	GPS_PARSE.lat = GPS_parse_coord();					break;
+		case 3:	GPS_PARSE.ns = GPS_PARSE.first;						break;
+		case 4:	GPS_PARSE.lon = GPS_parse_coord();					break;
+		case 5:	GPS_PARSE.ew = GPS_PARSE.first;						break;
+		case 6:	GPS_PARSE.quality = GPS_parse_scale(0);				break;
+		case 7:	GPS_PARSE.satellites = GPS_parse_scale(0);			break;
+		case 8:	GPS_PARSE.hdop = GPS_parse_scale(2);				break;
+		case 9:	//Meters -> [cm], the only signed field we read
+				GPS_PARSE.altitude = GPS_parse_scale(2);
+				if(GPS_PARSE.first == '-') GPS_PARSE.altitude = -GPS_PARSE.altitude;
+				break;
+		default: ;
+	}
+}
+void GPS_commit_GGA(void){
+	
+	GPS_FIX.UTC_TIME = GPS_PARSE.time / 100;
+	GPS_FIX.UTC_CENTI = GPS_PARSE.time % 100;
+	GPS_FIX.QUALITY = GPS_PARSE.quality;
+	GPS_FIX.SATELLITES = GPS_PARSE.satellites;
+	GPS_FIX.HDOP = GPS_PARSE.hdop;
+	GPS_FIX.ALTITUDE = GPS_PARSE.altitude;
+	
+	if(GPS_PARSE.quality){
+		GPS_FIX.LATITUDE = GPS_PARSE.ns == 'S' ? -GPS_PARSE.lat : GPS_PARSE.lat;
+		GPS_FIX.LONGITUDE = GPS_PARSE.ew == 'W' ? -GPS_PARSE.lon : GPS_PARSE.lon;
+	}
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_field_GSA(uint8_t field);
+					void GPS_commit_GSA(void);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	DOP and active satellites:
+					
+					1 Mode (A/M)	| 2 Fix Type (1 = none, 2 = 2D, 3 = 3D)	| 3-14 Satellite IDs
+					15 PDOP			| 16 HDOP								| 17 VDOP
+	
+*/
+void GPS_field_GSA(uint8_t field){
+	
+	switch(field){
+		case 2:		GPS_PARSE.fixType = GPS_parse_scale(0);			break;
+		case 16:	GPS_PARSE.hdop = GPS_parse_scale(2);			break;
+		default: ;
+	}
+}
+void GPS_commit_GSA(void){
+	
+	GPS_FIX.FIX_TYPE = GPS_PARSE.fixType;
+	GPS_FIX.HDOP = GPS_PARSE.hdop;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_field_VTG(uint8_t field);
+					void GPS_commit_VTG(void);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Course and speed over ground:
+					
+					1 Course (True)	| 2 T	| 3 Course (Magnetic)	| 4 M
+					5 Speed (Knots)	| 6 N	| 7 Speed (km/h)		| 8 K
+					
+					Published only while RMC reports a valid fix.
+	
+*/
+void GPS_field_VTG(uint8_t field){
+	
+	switch(field){
+		case 1:	GPS_PARSE.course = GPS_parse_scale(2);				break;
+		case 5:	GPS_PARSE.speed = GPS_parse_knots();				break;
+		default: ;
+	}
+}
+void GPS_commit_VTG(void){
+	
+	if(GPS_FIX.STATUS != 'A') return;
+	GPS_FIX.SPEED = GPS_PARSE.speed;
+	GPS_FIX.COURSE = GPS_PARSE.course;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_field_ACK(uint8_t field);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Reply to a PMTK command:
+					
+					1 Packet type acknowledged	| 2 Flag (GPS_ack, 0-3)
+					
+					Completes the matching command in GPS_TX.
+	
+*/
+void GPS_field_ACK(uint8_t field){
+	
+	switch(field){
+		case 1:	GPS_PARSE.ackId = GPS_PARSE.acc;					break;
+		case 2:	GPS_PARSE.ackFlag = GPS_PARSE.acc;					break;
+		default: ;
+	}
+}
+void GPS_commit_ACK(void){
+	
+	if(GPS_PARSE.ackFlag > GPS_ACK_OK) return;
+	GPS_ack_match();
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		uint8_t GPS_fix_usable(const GPS_data * fix);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Returns 1 if 'fix' is good enough to spend disk and LCD time on:
+					RMC reports valid data, GGA reports a fix from at least GPS_LOG_MIN_SATELLITES
+					satellites, and HDOP is no worse than GPS_LOG_MAX_HDOP.
+	
+*/
+uint8_t GPS_fix_usable(const GPS_data * fix){
+	
+	return fix->STATUS == 'A'
+		&& fix->QUALITY != 0
+		&& fix->SATELLITES >= GPS_LOG_MIN_SATELLITES
+		&& fix->HDOP <= GPS_LOG_MAX_HDOP;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_format_time(uint32_t time, char * str);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Writes seconds-of-day 'time' into 'str' as "hh:mm:ss", shifted from UTC to the
+					display time zone. 'str' must hold GPS_ASCII_TIME characters.
+	
+*/
+void GPS_format_time(uint32_t time, char * str){
+	
+	time = (time + GPS_SECONDS_PER_DAY - GPS_TIMEZONE_SHIFT * 3600UL) % GPS_SECONDS_PER_DAY;
+	uint16_t minutes = time / 60;
+	
+	GPS_put_uint(str, minutes / 60, 2);		str[2] = ':';
+	GPS_put_uint(str + 3, minutes % 60, 2);	str[5] = ':';
+	GPS_put_uint(str + 6, time % 60, 2);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_format_date(uint16_t date, char * str);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Writes packed 'date' into 'str' as "dd/mm/yy". 'str' must hold GPS_ASCII_DATE
+					characters.
+	
+*/
+void GPS_format_date(uint16_t date, char * str){
+	
+	GPS_put_uint(str, GPS_DATE_DAY(date), 2);		str[2] = '/';
+	GPS_put_uint(str + 3, GPS_DATE_MONTH(date), 2);	str[5] = '/';
+	GPS_put_uint(str + 6, GPS_DATE_YEAR(date), 2);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_format_coord(int32_t coord, char pos, char neg, char * str);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Writes 'coord' [1e-7 deg] into 'str' as unsigned decimal degrees with 5 places
+					(about 1 m), followed by hemisphere 'pos' or 'neg' (ex: "74.00695W"). 'str'
+					must hold GPS_ASCII_COORD characters.
+	
+*/
+void GPS_format_coord(int32_t coord, char pos, char neg, char * str){
+	
+	char hemisphere = coord < 0 ? neg : pos;
+	uint32_t val = (coord < 0 ? -coord : coord) / 100;		// [1e-5 deg]
+	
+	str = GPS_put_uint(str, val / 100000, 0);
+	*str++ = '.';
+	str = GPS_put_uint(str, val % 100000, 5);
+	*str++ = hemisphere;
+	*str = 0;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_format_decimal(int32_t val, uint8_t decimals, char * str);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Writes fixed-point 'val' into 'str' with 'decimals' places after the decimal
+					point (ex: val = 22111, decimals = 2 -> "221.11"). 'str' must hold
+					GPS_ASCII_DECIMAL characters.
+	
+*/
+void GPS_format_decimal(int32_t val, uint8_t decimals, char * str){
+	
+	uint32_t div = 1;
+	for(uint8_t i = 0; i < decimals; i++) div *= 10;
+	
+	if(val < 0){ *str++ = '-'; val = -val; }
+	str = GPS_put_uint(str, (uint32_t)val / div, 0);
+	if(decimals){
+		*str++ = '.';
+		GPS_put_uint(str, (uint32_t)val % div, decimals);
+	}
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		char * GPS_put_uint(char * dst, uint32_t val, uint8_t width);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Writes 'val' into 'dst' as decimal, zero-padded to at least 'width' digits,
+					followed by a terminating character. Returns a pointer to the terminator.
+	
+*/
+char * GPS_put_uint(char * dst, uint32_t val, uint8_t width){
+	
+	char tmp[10];
+	uint8_t n = 0;
+	
+	do{
+		tmp[n++] = '0' + (val % 10);
+		val /= 10;
+	} while(val || n < width);
+	
+	while(n) *dst++ = tmp[--n];
+	*dst = 0;
+	return dst;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_service(void);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Consumer side of the GPS_RX ring. Every byte enqueued by the receive interrupt
+					since the last call is handed to the streaming parser. The tail index is
+					published after each byte is read, so the interrupt can reuse the slot
+					immediately.
+					
+					Must only be called from the main loop (never from an ISR), since it is the
+					only writer of GPS_RX.tail. Draining stops at the sentence completing an epoch;
+					that fix is delivered to the subscribers, and the command awaiting a reply (if
+					any) ages by one epoch. The rest of the ring waits for the next call.
+	
+*/
+void GPS_service(void){
+	
+	uint8_t tail = GPS_RX.tail;
+	
+	//Drain what the ISR has produced so far, up to the end of the next complete epoch:
+	while(tail != GPS_RX.head && GPS_FIX.EPOCH == GPS_DELIVERED){
+		char data = GPS_RX.buff[tail];
+		tail = (tail + 1) & GPS_RING_MASK;
+		GPS_RX.tail = tail;
+		GPS_parse_byte(data);
+	}
+	
+	if(GPS_FIX.EPOCH != GPS_DELIVERED){
+		GPS_ack_age();
+		GPS_deliver();
+	}
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_deliver(void);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Takes one snapshot of the fix just completed and calls every subscriber whose
+					decimation count has been reached.
+	
+*/
+void GPS_deliver(void){
+	
+	GPS_data fix;
+	uint8_t epoch = GPS_snapshot(&fix);
+	uint8_t elapsed = epoch - GPS_DELIVERED;
+	GPS_DELIVERED = epoch;
+	
+	for(uint8_t i = 0; i < GPS_SUB_COUNT; i++){
+		GPS_subscriber * sub = &GPS_SUBS[i];
+		sub->count = (sub->count + elapsed < sub->every) ? sub->count + elapsed : sub->every;
+		if(sub->count >= sub->every){
+			sub->count = 0;
+			sub->handler(&fix);
+		}
+	}
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		uint8_t GPS_subscribe(GPS_handler handler, uint8_t every);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Registers 'handler' to be called with every 'every'-th published fix (1 = all
+					of them). Returns 1 if the table (GPS_SUBSCRIBER_MAX entries) is full.
+	
+*/
+uint8_t GPS_subscribe(GPS_handler handler, uint8_t every){
+	
+	if(GPS_SUB_COUNT >= GPS_SUBSCRIBER_MAX) return 1;
+	
+	GPS_SUBS[GPS_SUB_COUNT].handler = handler;
+	GPS_SUBS[GPS_SUB_COUNT].every = every ? every : 1;
+	GPS_SUBS[GPS_SUB_COUNT].count = 0;
+	GPS_SUB_COUNT++;
 	return 0;
 }
-
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 /*
-	FUNCTION:		void GPS_request_update(void);
+	FUNCTION:		void GPS_set_decimation(GPS_handler handler, uint8_t every);
 	AUTHOR:			Christopher DeFranco
 	
-	DESCRIPTION:	Enables the receiver, and the interrupt that handles incoming data.
-					Also maintains track of parser variables.
+	DESCRIPTION:	Changes the decimation of an existing subscriber (e.g. to keep a handler at the
+					same period in seconds when the output rate changes). Its count restarts.
 	
 */
-void GPS_request_update(void){
+void GPS_set_decimation(GPS_handler handler, uint8_t every){
 	
-	//Reset parser variables:
-	GPS_MESSAGE_READY = 0;
-	GPS_BUFFER_INDEX = 0;
-	SYS_GPS.IS_PROCESSING = 1;
-	//Enable receiver interrupt:
-	UCSR0B |= (1 << RXCIE0);
-
+	for(uint8_t i = 0; i < GPS_SUB_COUNT; i++){
+		if(GPS_SUBS[i].handler != handler) continue;
+		GPS_SUBS[i].every = every ? every : 1;
+		GPS_SUBS[i].count = 0;
+	}
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		GPS_rate GPS_set_rate(GPS_rate rate);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Asks the receiver for a new fix/output rate, capped to what the negotiated link
+					can carry. The PMTK300/PMTK220 pair is queued for the transmit interrupt, so
+					this returns immediately. Returns the rate now in effect, which is left
+					unchanged if the command queue has no room (the caller simply asks again).
+					Should the receiver reject either command, the rate reads back as unknown
+					(GPS_RATE_COUNT) until it is set again.
+	
+*/
+GPS_rate GPS_set_rate(GPS_rate rate){
+	
+	GPS_rate cap = pgm_read_byte(&GPS_BAUD_TABLE[GPS_LINK].maxRate);
+	if(rate > cap) rate = cap;
+	if(rate == GPS_RATE) return GPS_RATE;
+	
+	//Both commands or neither:
+	if(((GPS_TX.tail - GPS_TX.head - 1) & GPS_CMD_MASK) < 2) return GPS_RATE;
+	
+	GPS_queue_P(pgm_read_ptr(&GPS_RATE_TABLE[rate].setFix), GPS_rate_done);
+	GPS_queue_P(pgm_read_ptr(&GPS_RATE_TABLE[rate].setEcho), GPS_rate_done);
+	GPS_RATE = rate;
+	return rate;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		GPS_rate GPS_get_rate(void);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Returns the output rate last requested with GPS_set_rate() (after capping).
+	
+*/
+GPS_rate GPS_get_rate(void){
+	
+	return GPS_RATE;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_rate_done(uint16_t id, GPS_ack result);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Completion of a PMTK300/PMTK220 queued by GPS_set_rate(). A rejected or
+					unanswered command leaves the receiver's rate unknown.
+	
+*/
+void GPS_rate_done(uint16_t id, GPS_ack result){
+	
+	if(result != GPS_ACK_OK) GPS_RATE = GPS_RATE_COUNT;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		uint8_t GPS_queue_P(const unsigned char * cmd, GPS_ack_handler done);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Appends a NUL-terminated PROGMEM command to GPS_TX and starts the transmit
+					interrupt. 'done' (if not 0) is called from GPS_service() with the receiver's
+					reply, or with GPS_ACK_LOST. Returns 1 if the queue is full.
+	
+*/
+uint8_t GPS_queue_P(const unsigned char * cmd, GPS_ack_handler done){
+	
+	uint8_t head = GPS_TX.head;
+	uint8_t next = (head + 1) & GPS_CMD_MASK;
+	if(next == GPS_TX.tail) return 1;
+	
+	GPS_TX.slot[head].cmd = cmd;
+	GPS_TX.slot[head].done = done;
+	GPS_TX.slot[head].id = GPS_cmd_id(cmd);
+	
+	//Publish the slot and (re)start the interrupt. UCSR0B is shared with the ISR, so the
+	//read-modify-write must not be interrupted:
+	uint8_t sreg = SREG;
+	cli();
+	GPS_TX.head = next;
+	UCSR0B |= (1 << UDRIE0);
+	SREG = sreg;
+	return 0;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		uint16_t GPS_cmd_id(const unsigned char * cmd);
+	AUTHOR:			Christopher DeFranco
 	
+	DESCRIPTION:	Reads the packet type of a PROGMEM "$PMTKnnn,..." command, the number its
+					$PMTK001 reply carries.
 	
+*/
+uint16_t GPS_cmd_id(const unsigned char * cmd){
+	
+	uint16_t id = 0;
+	unsigned char data;
+	
+	cmd += 5;
+	while((data = pgm_read_byte(cmd++)) >= '0' && data <= '9') id = id * 10 + (data - '0');
+	return id;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_ack_retire(GPS_ack result);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Completes the oldest command awaiting a reply, frees its slot and reports the
+					result. Anything but GPS_ACK_OK is counted in GPS_STATS.nacks.
+	
+*/
+void GPS_ack_retire(GPS_ack result){
+	
+	GPS_cmd cmd = GPS_TX.slot[GPS_TX.tail];
+	
+	GPS_TX.tail = (GPS_TX.tail + 1) & GPS_CMD_MASK;
+	GPS_TX.age = 0;
+	
+	if(result != GPS_ACK_OK) GPS_STATS.nacks++;
+	if(cmd.done) cmd.done(cmd.id, result);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_ack_match(void);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Matches a verified $PMTK001 against the commands already sent. The receiver
+					answers in order, so commands sent ahead of the one acknowledged will never
+					get a reply and are retired as GPS_ACK_LOST. Replies matching nothing in
+					flight (e.g. to a probe sent before streaming) are ignored.
+	
+*/
+void GPS_ack_match(void){
+	
+	uint8_t sent = GPS_TX.send;
+	uint8_t i;
+	
+	for(i = GPS_TX.tail; i != sent; i = (i + 1) & GPS_CMD_MASK){
+		if(GPS_TX.slot[i].id == GPS_PARSE.ackId) break;
+	}
+	if(i == sent) return;
+	
+	while(GPS_TX.tail != i) GPS_ack_retire(GPS_ACK_LOST);
+	GPS_ack_retire(GPS_PARSE.ackFlag);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_ack_age(void);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Called once per published epoch. Gives up on the oldest sent command after
+					GPS_ACK_EPOCHS epochs without a reply.
+	
+*/
+void GPS_ack_age(void){
+	
+	if(GPS_TX.tail == GPS_TX.send){
+		GPS_TX.age = 0;
+		return;
+	}
+	if(++GPS_TX.age >= GPS_ACK_EPOCHS) GPS_ack_retire(GPS_ACK_LOST);
 }
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 /*
 	FUNCTION:		GPS_configure_firmware(void);
 	AUTHOR:			Christopher DeFranco
 	
-	DESCRIPTION:	This function assumes that the system USART baud rate was already configured
-					to operate at the appropriate baud rate. Ideally, the stream should be closed
-					when invoking this function. Therefore for proper initialization at the
-					outset of chip startup, the process should follow:
-					
-					1.	System recovery
-					2.	GPS_init_USART(9600);
-					3.	GPS_configure_firmware();
-					4.	GPS_enable_stream();
+	DESCRIPTION:	Sets up the USART and negotiates the link rate with the receiver (see
+					GPS_negotiate_baud), which needs its replies and so is the only part done
+					by polling. RMC+GGA output at 1 Hz is then queued for the transmit
+					interrupt. Finally publishes an empty fix and leaves the receiver streaming
+					into GPS_RX.
 	
 */
 void GPS_configure_firmware(void){
 
-	//We want our system to receive sentences as fast as possible, but only of RMC type:
+	//We want our system to receive sentences as fast as possible, but only of RMC and GGA type:
 	
 	GPS_init_USART(MY_UBBR);
 	
-	//1. BAUD TO 9600
-	for(uint8_t i = 0; i < 18; i++){
-		GPS_USART_Transmit(pgm_read_byte(&FIRM_BAUD[i]));
-	}
+	//1. Move the link to the fastest rate the receiver will confirm:
+	GPS_LINK = GPS_negotiate_baud();
 	
-	//1. RMC ONLY!
-	for(uint8_t i = 0; i < 51; i++){
-		GPS_USART_Transmit(pgm_read_byte(&FIRM_RMC[i]));
-			}
+	//2. Everything from here on is queued, and goes out from the transmit interrupt once
+	//interrupts are enabled:
+	memset(&GPS_TX, 0, sizeof(GPS_TX));
 	
-	//2. 10HZ data echoing:
-	for(uint8_t i = 0; i < 17; i++){
-		GPS_USART_Transmit(pgm_read_byte(&FIRM_ECHO_10HZ[i]));
-			}
+	//3. RMC + GGA (GGA carries fix quality, satellites, HDOP and altitude):
+	GPS_queue_P(FIRM_RMC_GGA, 0);
 	
-	////3. Fast position fix:
+	//4. Start slow (the receiver may still hold a rate from before a warm restart), and let the
+	//application raise it with GPS_set_rate() once it knows what it needs:
+	GPS_RATE = GPS_RATE_COUNT;
+	GPS_set_rate(GPS_RATE_1HZ);
+	
+	////4. Fast position fix:
 	//for(uint8_t i = 0; i < 25; i++){
 		//GPS_USART_Transmit(pgm_read_byte(&FIRM_FIX_5HZ[i]));
 	//}
 			
-	/* Set Default Strings */
-	SYS_GPS.STATUS = 'V';
-	strcpy(SYS_GPS.UTC_TIME_ASCII,"00:00:00");	strcpy(SYS_GPS.UTC_TIME_ASCII_LAST,"00:00:00");
-	strcpy(SYS_GPS.UTC_DATE_ASCII,"00/00/00");
-	strcpy(SYS_GPS.LATITUDE_ASCII,"00000000");		strcpy(SYS_GPS.LATITUDE_ASCII_LAST,"00000000");
-	strcpy(SYS_GPS.LONGITUDE_ASCII,"000000000");	strcpy(SYS_GPS.LONGITUDE_ASCII_LAST,"000000000");
-	strcpy(SYS_GPS.SPEED_ASCII,"0");
-	strcpy(SYS_GPS.COURSE_ASCII,"000");
-	SYS_GPS.NS = 'N';
-	SYS_GPS.EW = 'E';
-	SYS_GPS.IS_PROCESSING=0;
+	/* Set Default Fix */
+	memset(&GPS_FIX, 0, sizeof(GPS_FIX));
+	GPS_FIX.STATUS = 'V';
+	GPS_PARSE.seen = 0;
+	GPS_publish();
+	GPS_DELIVERED = GPS_FIX.EPOCH;
+	
+	/* Stream Continuously From Here On */
+	GPS_enable_stream();
 }
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 /*
@@ -469,6 +1279,151 @@ void GPS_USART_Transmit(unsigned char data){
 	
 }
 ////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_send_P(const unsigned char * cmd);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Transmits the NUL-terminated PROGMEM command 'cmd', and returns only once its
+					last stop bit has left the line (TXC0), so the baud rate may be changed
+					straight afterwards.
+	
+*/
+void GPS_send_P(const unsigned char * cmd){
+	
+	unsigned char data;
+	
+	//Clear transmit-complete (written as 1), keeping the speed/mode bits:
+	UCSR0A = (UCSR0A & ((1 << U2X0)|(1 << MPCM0))) | (1 << TXC0);
+	
+	while((data = pgm_read_byte(cmd++))) GPS_USART_Transmit(data);
+	while(!(UCSR0A & (1 << TXC0)));
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		void GPS_set_baud(uint8_t index);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Reprograms UBRR0 (in double-speed mode) for entry 'index' of GPS_BAUD_TABLE.
+	
+*/
+void GPS_set_baud(uint8_t index){
+	
+	UCSR0A |= (1 << U2X0);
+	UBRR0H = 0;
+	UBRR0L = pgm_read_byte(&GPS_BAUD_TABLE[index].ubrr);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		uint8_t GPS_await_P(const unsigned char * reply);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Polls the receiver (the receive interrupt must be off) until the PROGMEM
+					string 'reply' has been seen, or GPS_REPLY_POLLS polls pass. Returns 1 on a
+					match. A framing error or unexpected character restarts the match, so line
+					noise at the wrong rate never reads as a reply.
+	
+*/
+uint8_t GPS_await_P(const unsigned char * reply){
+	
+	uint8_t matched = 0;
+	
+	for(uint16_t polls = 0; polls < GPS_REPLY_POLLS; polls++){
+		if(!(UCSR0A & (1 << RXC0))){
+			_delay_us(10);
+			continue;
+		}
+		
+		uint8_t framing = UCSR0A & (1 << FE0);
+		char data = UDR0;
+		
+		if(framing) matched = 0;
+		else if(data == pgm_read_byte(&reply[matched])) matched++;
+		else matched = (data == pgm_read_byte(&reply[0])) ? 1 : 0;
+		
+		if(!pgm_read_byte(&reply[matched])) return 1;
+	}
+	
+	return 0;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		uint8_t GPS_probe_baud(uint8_t index);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Switches the USART to entry 'index' of GPS_BAUD_TABLE and sends the PMTK test
+					packet. Returns 1 if the receiver acknowledges it at that rate.
+	
+*/
+uint8_t GPS_probe_baud(uint8_t index){
+	
+	GPS_set_baud(index);
+	
+	for(uint8_t i = 0; i < GPS_PROBE_TRIES; i++){
+		GPS_send_P(FIRM_TEST);
+		if(GPS_await_P(FIRM_TEST_ACK)) return 1;
+	}
+	
+	return 0;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		uint8_t GPS_find_baud(void);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Probes every entry of GPS_BAUD_TABLE, fastest first. The receiver keeps the
+					last PMTK251 rate for as long as it has backup power, so this cannot assume
+					the factory rate. Returns the answering index (USART left at that rate), or
+					GPS_BAUD_COUNT if none answered.
+	
+*/
+uint8_t GPS_find_baud(void){
+	
+	for(uint8_t i = 0; i < GPS_BAUD_COUNT; i++){
+		if(GPS_probe_baud(i)) return i;
+	}
+	
+	return GPS_BAUD_COUNT;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	FUNCTION:		uint8_t GPS_negotiate_baud(void);
+	AUTHOR:			Christopher DeFranco
+	
+	DESCRIPTION:	Moves the link to GPS_BAUD_TARGET:
+					
+					1.	Find the receiver's current rate.
+					2.	Send PMTK251 for the target rate at the current rate.
+					3.	Confirm with a PMTK test packet at the target rate.
+					
+					If the target does not confirm, the link falls back to whichever rate answers
+					(or the factory rate if none does). Returns the GPS_BAUD_TABLE index in use.
+	
+*/
+uint8_t GPS_negotiate_baud(void){
+	
+	//Poll for replies, keep the parser out of the way:
+	GPS_disable_stream();
+	
+	//1. Current rate:
+	uint8_t current = GPS_find_baud();
+	if(current == GPS_BAUD_TARGET) return current;
+	
+	//2. and 3. Request and confirm the target rate:
+	if(current != GPS_BAUD_COUNT){
+		GPS_send_P(pgm_read_ptr(&GPS_BAUD_TABLE[GPS_BAUD_TARGET].setBaud));
+		if(GPS_probe_baud(GPS_BAUD_TARGET)) return GPS_BAUD_TARGET;
+		
+		//Fall back to whatever the receiver ended up at:
+		current = GPS_find_baud();
+	}
+	
+	if(current == GPS_BAUD_COUNT){
+		current = GPS_BAUD_DEFAULT;
+		GPS_set_baud(current);
+	}
+	return current;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
 /*
 	FUNCTION:		void GPS_enable_stream(void);
 	AUTHOR:			Christopher DeFranco
@@ -487,9 +1442,6 @@ void GPS_USART_Transmit(unsigned char data){
 			//Flush the buffer each time, such that there is a fresh start:
 			GPS_flush_buffer();
 	
-			//Also make sure that the parsing flag is reset as well to prevent erroneous behavior:
-			GPS_MESSAGE_READY = 0;
-	
 			//Set receiver-interrupt enable bit, while maintaining register contents:
 			UCSR0B |= (1 << RXCIE0);
 	
@@ -551,23 +1503,14 @@ char GPS_receive_byte(void){
 	FUNCTION:		void GPS_flush_buffer(void);
 	AUTHOR:			Christopher DeFranco
 	
-	DESCRIPTION:	Systematically clears out the data contained in the USART receive buffer, 
-					then sets the value of the head pointer to 0;
+	DESCRIPTION:	Abandons any partially received sentence, so the parser waits for the next
+					'$' before decoding again.
 	
 */
 void GPS_flush_buffer(void){
 	
-	//Clear out data
-	for(int i = 0; i < GPS_BYTES_ASCII_TOTAL; i++){
-		GPS_BUFFER[i] = 0;
-	}
-	
-	//Set pointer to zero:
-	GPS_BUFFER_INDEX = 0;				//Buffer is at start position.
-	
-	//Clear the pre-parsing flag:
-	GPS_MESSAGE_READY = 0;				//Buffer is closed off.
-	
+	//Return the parser to its idle state:
+	GPS_PARSE.state = GPS_ST_IDLE;
 	
 }
 
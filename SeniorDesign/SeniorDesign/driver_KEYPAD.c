@@ -4,28 +4,39 @@
 //									  Keypad Driver Objects									      //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 int globalOption = 0;
+static void (* volatile pendingTask)() = 0;
 
 /* Do (Basically) Nothing */
 void null_tsk(){SFX_tone(100,200);}
 
 /****************** MODIFIABLE ******************/
 
-const Options optionsMAIN[] = {
+const Options optionsMAIN[] PROGMEM = {
 	{APP_startMode_debug,	"Navigation Data"	},
 	{APP_startMode_trace,	"Trace Mode"		},
-	{SFX_toggle_enabled,	"Toggle Buzzer"		}
+	{APP_startMode_retrace,	"Retrace"			},
+	{APP_startMode_follow,	"Follow Trace"		},
+	{SFX_toggle_enabled,	"Toggle Buzzer"		},
+#ifdef DEBUG
+	{APP_trips_today,		"Trips Today"		},
+#endif
 };
 
-const Options optionsDEBUG[] = {
+const Options optionsDEBUG[] PROGMEM = {
+#ifdef DEBUG
+	{APP_benchmark_math,	"Bench Math"		},
+#else
 	{null_tsk,				"Save Coordinate"	},
+#endif
 	{APP_startMode_main,	"Exit"				}
 };
 
-const Options optionsTRACE[] = {
+const Options optionsTRACE[] PROGMEM = {
 //	{null_tsk,				"Start"				},
 	{null_tsk,				"Sleep"				},
 	{null_tsk,				"Recover"			},
 	{null_tsk,				"GPS"				},
+	{APP_toggle_pan,		"Pan Map"			},
 	{APP_startMode_main,	"Exit"				}
 };
 
@@ -59,16 +70,27 @@ void KEY_setState(uint8_t state)
 
 void KEY_execute()
 {
-	/* Execute Task Based on Screen and Option # */
+	/* Latch Task Based on Screen and Option # (Tables Live in Flash) */
 	EIFR = 0xFF;
-	sei();
 	switch(screen){
-		case MAINSCREEN:	optionsMAIN[globalOption].task();	return;
-		case DEBUGSCREEN:	optionsDEBUG[globalOption].task();	return;
-		case TRACESCREEN:	optionsTRACE[globalOption].task();	return;
+		case MAINSCREEN:	pendingTask = (void (*)())pgm_read_word(&optionsMAIN[globalOption].task);	return;
+		case DEBUGSCREEN:	pendingTask = (void (*)())pgm_read_word(&optionsDEBUG[globalOption].task);	return;
+		case TRACESCREEN:	pendingTask = (void (*)())pgm_read_word(&optionsTRACE[globalOption].task);	return;
 	}
 }
 
+void KEY_service()
+{
+	/* Take Latched Task (Pointer Is NOT Written Atomically By The ISR) */
+	cli();
+	void (*task)() = pendingTask;
+	pendingTask = 0;
+	sei();
+	
+	/* Run Task */
+	if(task) task();
+}
+
 void KEY_scroll(int key)
 {
 	/* Set # of Options */
@@ -149,6 +149,26 @@ void LCD_drawRect_empty (uint16_t x, uint16_t y, uint16_t w, uint16_t h, Color c
 }
 
 
+void LCD_openWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+	/* Select (x,y) to (x+w-1,y+h-1) Drawing Zone */
+	LCD_setAddress(x, y, x+w-1, y+h-1);
+}
+
+
+void LCD_pushRun(Color color, uint16_t count)
+{
+	/* Send 'count' Pixels Under One Chip Select */	// ***
+	SPPORT |= (1<<LDC);								// Set data-mode
+	SPPORT &= ~(1<<LCS);							// Enable chip select
+	while(count--){									// For every pixel,
+		LCD_spi_send(color>>8);						//  Send color data
+		LCD_spi_send(color);						//  ...
+	}
+	SPPORT |= (1<<LCS);								// Disable chip select
+}
+
+
 void LCD_drawCircle_filled(uint16_t x0, uint16_t y0, uint8_t radius, Color color)
 {
 	if(radius == 1) { LCD_drawPixel(x0,y0,color); return; }
@@ -335,6 +355,14 @@ void LCD_print_str(char * str)
 		LCD_print_char(str[i]);					//  Print letter
 }
 
+void LCD_print_str_P(const char * str)
+{
+	/* Print all letters of flash string 'str' */	// ***
+	char c;											//
+	while((c = pgm_read_byte(str++)))				// For each letter in 'str'
+		LCD_print_char(c);							//  Print letter
+}
+
 void LCD_println_str(char * str)
 {
 	/* Print 'str' with newline */
@@ -342,6 +370,13 @@ void LCD_println_str(char * str)
 	LCD_print_char('\n');
 }
 
+void LCD_println_str_P(const char * str)
+{
+	/* Print flash string 'str' with newline */
+	LCD_print_str_P(str);
+	LCD_print_char('\n');
+}
+
 void LCD_print_str_len(char * str, uint8_t len)
 {
 	/* Print 'len' letters of 'str' */	// ***
@@ -382,12 +417,12 @@ void LCD_generateScreen(ScreenType type)
 		LCD_setIconState(GPSICON,0);
 		LCD_setText(MAINSCREEN_IDENTIFIER_XOFF, MAINSCREEN_IDENTIFIER_YOFF, MAINSCREEN_IDENTIFIER_SIZE,MAINSCREEN_IDENTIFIER_COLOR,MAINSCREEN_SCREENCOLOR);
 		LCD_drawRect_empty(MAINSCREEN_IDENTIFIER_XOFF - MAINSCREEN_BORDEROFF, MAINSCREEN_IDENTIFIER_YOFF - MAINSCREEN_BORDEROFF, strlen("MAIN") * 6 * MAINSCREEN_IDENTIFIER_SIZE + MAINSCREEN_BORDEROFF * 2, 8 * MAINSCREEN_IDENTIFIER_SIZE + MAINSCREEN_BORDEROFF * 2, MAINSCREEN_IDENTIFIER_COLOR);
-		LCD_print_str("MAIN\n\n");
+		LCD_print_str_P(PSTR("MAIN\n\n"));
 		/* Print Options */
 		LCD_setText(MAINSCREEN_OPTION_X,MAINSCREEN_OPTION_Y,MAINSCREEN_OPTION_SIZE,MAINSCREEN_OPTION_COLOR,MAINSCREEN_SCREENCOLOR);
 	
 		for(int i = 0; i < MAINSCREEN_OPTION_COUNT; i++){
-			LCD_print_str("   ");	LCD_println_str(optionsMAIN[i].label);
+			LCD_print_str_P(PSTR("   "));	LCD_println_str_P(optionsMAIN[i].label);
 		}
 		pencil.x = MAINSCREEN_OPTION_X; pencil.y = MAINSCREEN_OPTION_Y;
 		LCD_print_char('>');
@@ -402,22 +437,24 @@ void LCD_generateScreen(ScreenType type)
 		LCD_setIconState(GPSICON,0);
 		LCD_setText(DEBUGSCREEN_IDENTIFIER_XOFF, DEBUGSCREEN_IDENTIFIER_YOFF, DEBUGSCREEN_IDENTIFIER_SIZE,DEBUGSCREEN_IDENTIFIER_COLOR,DEBUGSCREEN_SCREENCOLOR);
 		LCD_drawRect_empty(DEBUGSCREEN_IDENTIFIER_XOFF - DEBUGSCREEN_BORDEROFF, DEBUGSCREEN_IDENTIFIER_YOFF - DEBUGSCREEN_BORDEROFF, strlen("DEBUG") * 6 * DEBUGSCREEN_IDENTIFIER_SIZE + DEBUGSCREEN_BORDEROFF * 2, 8 * DEBUGSCREEN_IDENTIFIER_SIZE + DEBUGSCREEN_BORDEROFF * 2, DEBUGSCREEN_IDENTIFIER_COLOR);
-		LCD_print_str("DEBUG\n\n");
+		LCD_print_str_P(PSTR("DEBUG\n\n"));
 		/* Print GPS Parameter List */
 		pencil.size = DEBUGSCREEN_TEXT_SIZE;
 		pencil.fg = DEBUGSCREEN_TEXT_COLOR;
-		LCD_print_str("Time (UTC) :\n");
-		LCD_print_str("Date       :\n");
-		LCD_print_str("Data Status:\n");
-		LCD_print_str("Latitude   :\n");
-		LCD_print_str("Longitude  :\n");
-		LCD_print_str("Speed      :\n");
-		LCD_print_str("Course     :\n\n\n");
+		LCD_print_str_P(PSTR("Time (UTC) :\n"));
+		LCD_print_str_P(PSTR("Date       :\n"));
+		LCD_print_str_P(PSTR("Stat/Sat/HD:\n"));
+		LCD_print_str_P(PSTR("Latitude   :\n"));
+		LCD_print_str_P(PSTR("Longitude  :\n"));
+		LCD_print_str_P(PSTR("Speed      :\n"));
+		LCD_print_str_P(PSTR("Course     :\n"));
+		LCD_print_str_P(PSTR("NMEA Good  :\n"));
+		LCD_print_str_P(PSTR("NMEA Bad/OV:\n"));
 		/* Print Options */
 		LCD_setText(DEBUGSCREEN_OPTION_X,DEBUGSCREEN_OPTION_Y,DEBUGSCREEN_OPTION_SIZE,DEBUGSCREEN_OPTION_COLOR,DEBUGSCREEN_SCREENCOLOR);
 		
 		for(int i = 0; i < DEBUGSCREEN_OPTION_COUNT; i++){
-			LCD_print_str("   ");	LCD_println_str(optionsDEBUG[i].label);
+			LCD_print_str_P(PSTR("   "));	LCD_println_str_P(optionsDEBUG[i].label);
 		}
 		pencil.x = DEBUGSCREEN_OPTION_X; pencil.y = DEBUGSCREEN_OPTION_Y;
 		LCD_print_char('>');
@@ -436,17 +473,17 @@ void LCD_generateScreen(ScreenType type)
 		LCD_drawRect_empty(NAVSCREEN_INFO_PANEX,NAVSCREEN_INFO_PANEY,NAVSCREEN_INFO_PANEW,NAVSCREEN_INFO_PANEH,NAVSCREEN_INFO_PANECOLOR);
 		/* Print Text */
 		LCD_setText(NAVSCREEN_DIRA_TEXTX,NAVSCREEN_DIRA_TEXTY,NAVSCREEN_DIRA_SIZE,NAVSCREEN_DIRA_PANECOLOR,NAVSCREEN_SCREENCOLOR);
-		LCD_print_str("Now: ");
+		LCD_print_str_P(PSTR("Now: "));
 		LCD_setText(NAVSCREEN_DIRB_TEXTX,NAVSCREEN_DIRB_TEXTY,NAVSCREEN_DIRB_SIZE,NAVSCREEN_DIRB_PANECOLOR,NAVSCREEN_SCREENCOLOR);
-		LCD_print_str("Last:");
+		LCD_print_str_P(PSTR("Last:"));
 		LCD_setText(NAVSCREEN_UTC_TEXTX,TFTHEIGHT-10,1,BLUE,NAVSCREEN_SCREENCOLOR);
-		LCD_print_str("TRACEMODE");
+		LCD_print_str_P(PSTR("TRACEMODE"));
 		LCD_setText(NAVSCREEN_INFO_TEXTX,NAVSCREEN_INFO_TEXTY,2,NAVSCREEN_INFO_PANECOLOR,NAVSCREEN_SCREENCOLOR);
-		LCD_print_str("Options:");
+		LCD_print_str_P(PSTR("Options:"));
 		LCD_setText(NAVSCREEN_OPTION_X,NAVSCREEN_OPTION_Y,NAVSCREEN_OPTION_SIZE,NAVSCREEN_OPTION_COLOR,NAVSCREEN_SCREENCOLOR);
 		
 		for(int i = 0; i < NAVSCREEN_OPTION_COUNT; i++){
-			LCD_print_str("   ");	LCD_println_str(optionsTRACE[i].label);
+			LCD_print_str_P(PSTR("   "));	LCD_println_str_P(optionsTRACE[i].label);
 		}
 		pencil.x = NAVSCREEN_OPTION_X; pencil.y = NAVSCREEN_OPTION_Y;
 		LCD_print_char('>');
@@ -483,8 +520,8 @@ void LCD_moveScreenCursor(uint8_t optionNumber)
 
 	/* Redraw Pointer */
 	for(int i = 0; i < optionCount; i++){
-		if(i == optionNumber)	LCD_print_str(">\n");
-		else					LCD_print_str(" \n");
+		if(i == optionNumber)	LCD_print_str_P(PSTR(">\n"));
+		else					LCD_print_str_P(PSTR(" \n"));
 	}
 }
 
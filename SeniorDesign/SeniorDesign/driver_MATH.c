@@ -0,0 +1,176 @@
+#include "header_MATH.h"
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//									     MATH Driver Object									      //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+const int16_t mathSin[91] PROGMEM = {	// sin for every whole degree of the quarter wave [Q15]
+	0, 572, 1144, 1715, 2286, 2856, 3425, 3993, 4560, 5126,
+	5690, 6252, 6813, 7371, 7927, 8481, 9032, 9580, 10126, 10668,
+	11207, 11743, 12275, 12803, 13328, 13848, 14364, 14876, 15383, 15886,
+	16383, 16876, 17364, 17846, 18323, 18794, 19260, 19720, 20173, 20621,
+	21062, 21497, 21925, 22347, 22762, 23170, 23571, 23964, 24351, 24730,
+	25101, 25465, 25821, 26169, 26509, 26841, 27165, 27481, 27788, 28087,
+	28377, 28659, 28932, 29196, 29451, 29697, 29934, 30162, 30381, 30591,
+	30791, 30982, 31163, 31335, 31498, 31650, 31794, 31927, 32051, 32165,
+	32269, 32364, 32448, 32523, 32587, 32642, 32687, 32722, 32747, 32762,
+	32767
+};
+const uint16_t mathAtan[MATH_ATAN_STEPS+1] PROGMEM = {	// atan(k / 32) [0.1 deg]
+	0, 18, 36, 54, 71, 89, 106, 123, 140, 157, 174,
+	190, 206, 221, 236, 251, 266, 280, 294, 307, 320, 333,
+	345, 357, 369, 380, 391, 402, 412, 422, 432, 441, 450
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//									    MATH Public Functions									  //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+int16_t MATH_sin(int16_t deg)
+{
+	/* Reduce to One Turn (Only Outside It: the Divide Costs More Than the Rest), Then Mirror the Quarter Wave */
+	if((uint16_t)deg >= 360){
+		deg %= 360;
+		if(deg < 0) deg += 360;
+	}
+	if(deg <= 90)	return  pgm_read_word(&mathSin[deg]);
+	if(deg <= 180)	return  pgm_read_word(&mathSin[180 - deg]);
+	if(deg <= 270)	return -pgm_read_word(&mathSin[deg - 180]);
+	return -pgm_read_word(&mathSin[360 - deg]);
+}
+
+int16_t MATH_cos(int16_t deg)
+{
+	/* cos(a) = sin(a + 90), a Turn Back First Where That Would Overflow */
+	return MATH_sin((deg > INT16_MAX - 90 ? deg - 360 : deg) + 90);
+}
+
+uint16_t MATH_cos_frac(uint8_t deg, uint8_t frac)
+{
+	/* Whole Degrees Either Side, Read Backwards Off the Sine Table */
+	if(deg >= 90) return 0;
+	uint16_t c0 = pgm_read_word(&mathSin[90 - deg]);
+	uint16_t c1 = pgm_read_word(&mathSin[89 - deg]);
+	return c0 - (uint16_t)(((uint32_t)(c0 - c1) * frac) >> 8);
+}
+
+uint16_t MATH_atan2(int32_t y, int32_t x)
+{
+	/* Fold Onto the First Octant: 0 <= lo <= hi */
+	uint32_t ax = x < 0 ? -(uint32_t)x : (uint32_t)x;
+	uint32_t ay = y < 0 ? -(uint32_t)y : (uint32_t)y;
+	uint32_t hi = ax > ay ? ax : ay;
+	uint32_t lo = ax > ay ? ay : ax;
+	if(hi == 0) return 0;
+	
+	/* tan [1/4096] by Long Division: Only 13 Quotient Bits, Where a 32-Bit Divide Makes 32 */
+	uint16_t r = 0;
+	for(uint8_t k = 0; k < 13; k++)
+	{
+		r <<= 1;
+		if(lo >= hi){ lo -= hi; r |= 1; }
+		lo <<= 1;														// lo < hi <= 2^31: can't overflow
+	}
+	
+	/* Octant Angle From the Table, Interpolated Over the Step */
+	uint8_t i = r >> 7;
+	uint16_t a = pgm_read_word(&mathAtan[i]);
+	if(i < MATH_ATAN_STEPS) a += ((pgm_read_word(&mathAtan[i + 1]) - a) * (r & 127) + 64) >> 7;
+	
+	/* Unfold: Past the Diagonal, Then Into the Quadrant */
+	if(ay > ax) a = 90 * MATH_ATAN_SCALE - a;
+	if(x < 0) a = 180 * MATH_ATAN_SCALE - a;
+	if(y < 0) a = 360 * MATH_ATAN_SCALE - a;
+	
+	/* Round to Whole Degrees by Multiply and Shift (Exact Over 0..3605), 360 Wrapping to 0 */
+	uint16_t deg = ((uint32_t)(a + MATH_ATAN_SCALE / 2) * (65536 / MATH_ATAN_SCALE + 1)) >> 16;
+	return deg == 360 ? 0 : deg;
+}
+
+uint16_t MATH_bearing(int32_t dx, int32_t dy)
+{
+	/* North Is the Reference Axis and East the Positive Turn: atan2 With the Axes Swapped */
+	return MATH_atan2(dx,dy);
+}
+
+uint16_t MATH_isqrt(uint32_t val)
+{
+	/* Integer Square Root, a Result Bit Per Round */
+	uint32_t root = 0;
+	uint32_t bit = 1UL << 30;
+	while(bit > val) bit >>= 2;
+	while(bit)
+	{
+		if(val >= root + bit){
+			val -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else root >>= 1;
+		bit >>= 2;
+	}
+	return root;
+}
+
+uint32_t MATH_hypot(int32_t dx, int32_t dy)
+{
+	/* Scale Down Until the Squares Can't Overflow, and Back Up After */
+	uint32_t ax = dx < 0 ? -(uint32_t)dx : (uint32_t)dx;
+	uint32_t ay = dy < 0 ? -(uint32_t)dy : (uint32_t)dy;
+	uint8_t shift = 0;
+	while(ax > 0x7FFF || ay > 0x7FFF){ ax >>= 1; ay >>= 1; shift++; }
+	return (uint32_t)MATH_isqrt(ax * ax + ay * ay) << shift;
+}
+
+#ifdef DEBUG
+#include <avr/interrupt.h>
+#include <math.h>
+
+/* Benchmark Operands: Volatile, So Each Call Lands Between the Two Timer Reads */
+static volatile int32_t benchA, benchB;
+static volatile int32_t benchOut;
+static volatile float benchOutF;
+
+/* Add the Cycles 'expr' Takes to 'sum', Interrupts Held Off */
+#define MATH_TIME(sum,expr) do{				\
+	uint8_t sreg = SREG;					\
+	cli();									\
+	uint16_t t0 = TCNT1;					\
+	expr;									\
+	uint16_t t1 = TCNT1;					\
+	SREG = sreg;							\
+	sum += (uint16_t)(t1 - t0);				\
+}while(0)
+
+void MATH_benchmark(MathBench * bench)
+{
+	/* Free-Run Timer 1 at the CPU Clock, Buzzer Silenced */
+	uint8_t tccr1b = TCCR1B;
+	TCCR1A = 0;
+	TCCR1B = (1<<CS10);
+	
+	/* Sweep Angles Over Two Turns Either Way, Vectors Over Every Quadrant at Fix-Sized Magnitudes */
+	uint32_t none = 0, fixed[MATH_BENCH_COUNT] = {0}, real[MATH_BENCH_COUNT] = {0};
+	for(uint8_t i = 0; i < MATH_BENCH_RUNS; i++)
+	{
+		benchA = (int32_t)i * 23 - 720;
+		MATH_TIME(none,							benchOut = benchA);
+		MATH_TIME(fixed[MATH_BENCH_SIN],		benchOut = MATH_sin(benchA));
+		MATH_TIME(real[MATH_BENCH_SIN],			benchOutF = sin(benchA * (M_PI / 180)));
+		MATH_TIME(fixed[MATH_BENCH_COS],		benchOut = MATH_cos(benchA));
+		MATH_TIME(real[MATH_BENCH_COS],			benchOutF = cos(benchA * (M_PI / 180)));
+		
+		benchA = (int32_t)i * 1234567 - 40000000;
+		benchB = (int32_t)(MATH_BENCH_RUNS - i) * 987654 - 30000000;
+		MATH_TIME(fixed[MATH_BENCH_ATAN2],		benchOut = MATH_atan2(benchA,benchB));
+		MATH_TIME(real[MATH_BENCH_ATAN2],		benchOutF = atan2(benchA,benchB) * (180 / M_PI));
+		MATH_TIME(fixed[MATH_BENCH_HYPOT],		benchOut = MATH_hypot(benchA,benchB));
+		MATH_TIME(real[MATH_BENCH_HYPOT],		benchOutF = sqrt((float)benchA * benchA + (float)benchB * benchB));
+	}
+	
+	/* Give Timer 1 Back */
+	TCCR1B = tccr1b;
+	
+	/* Per Call, Less the Bare Timer Reads and Operand Move */
+	for(uint8_t k = 0; k < MATH_BENCH_COUNT; k++)
+	{
+		bench[k].fixed = (fixed[k] - none) / MATH_BENCH_RUNS;
+		bench[k].real = (real[k] - none) / MATH_BENCH_RUNS;
+	}
+}
+#endif
@@ -11,8 +11,11 @@
 #include "header_SFX.h"
 #include "header_FUNCTIONS.h"
 #include "header_DISK.h"
+#include "header_MATH.h"
 
 #include <avr/io.h>
+#include <util/crc16.h>
+#include <stddef.h>
 #include <stdio.h>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -25,13 +28,16 @@
 		Organizes all types of data encountered in application memory, including: 
 			
 			SIGNATURE    - Signature         - 8-bit MCU and Card linkage
-			M_TRACE      - Trace             - Contains a bitmap of routers/string of nodes
+			M_TRACE      - Trace             - Contains a quadrant directory/string of nodes
 			M_SINGULAR   - Single Coordinate - Similar to nodes, but unbound to quadrants
 			D_ROUTER     - Router            - Map to quadrant-starting/continuing nodes in trace
 			D_NORMALNODE - Normal Node       - Contains relative position/invisible UTC data
 			D_SUPERNODE  - Super Node        - Contains relative position/visible UTC data
 			D_ORIGINNODE - Origin Node       - Contains absolute position/visible UTC data
 			D_REFNODE    - Reference Node    - Contains absolute position/invisible UTC data
+			D_DIRECTORY  - Directory         - Map from quadrant to its router sector
+			D_INDEX      - Index             - Node positions of a quadrant, next to its router
+			D_TILE       - Tile              - Rendered map pane of a quadrant, after its index
 			
 ***************************************************************************************************/
 typedef enum {
@@ -42,7 +48,10 @@ typedef enum {
 	D_NORMALNODE,
 	D_SUPERNODE,
 	D_ORIGINNODE,
-	D_REFNODE
+	D_REFNODE,
+	D_DIRECTORY,
+	D_INDEX,
+	D_TILE
 	
 } DataType;
 
@@ -66,19 +75,403 @@ typedef enum {
 
 typedef struct {
 	uint8_t isDGPSon;
+	uint8_t isPanOn;				// Map pane follows the position instead of jumping a quadrant at a time
 	ModeType mode;
 	uint16_t entryCount;
 	uint32_t liveSector;
+	uint8_t liveCount;				// Node records already in liveSector
+	uint32_t freeSector;			// First sector not yet handed out (pages, routers, directories)
 } SettingHandler;
 
+/***************************************************************************************************
+	Type Definition: ManifestEntry (Data Structure)
+	Description:
+		One entry of the manifest table. Entries are packed MAN_ENTRIES to a sector, entry 'eid'
+		(from 1) in slot MAN_ENTRY_SLOT(eid) of sector MAN_ENTRY_SECTOR(eid). They are written
+		as their trace opens and summarised when it closes, so their start stamps only grow and the
+		table is searched by time with a binary search over its sectors (APP_manifest_find_time):
+		
+			start:      first page of the trace's nodes
+			end:        page its last node went to
+			directory:  first sector of its quadrant directory (0 for a single coordinate)
+			nodes:      records written
+			t0, t1:     APP_STAMP of its start and of its last node [s]
+			distance:   length of the track, moving (straight across lost fixes) [cm]
+			moving:     time between fixes spent moving (at TRIP_MOVING or faster) [s]
+			stopped:    ...and standing still [s]
+			maxSpeed:   fastest ground speed while moving [cm/s] (APP_TRIP_AVERAGE gives the mean)
+			lon0..lat1: bounding box of its fixes [1e-7 deg]
+			
+***************************************************************************************************/
+typedef struct {
+	uint8_t magic;
+	uint8_t type;
+	uint8_t closed;					// Summary is complete (an open entry holds the start only)
+	uint8_t reserved;
+	uint32_t start;
+	uint32_t end;
+	uint32_t directory;
+	uint32_t nodes;
+	uint32_t t0;
+	uint32_t t1;
+	uint32_t distance;
+	uint32_t moving;
+	uint32_t stopped;
+	uint16_t maxSpeed;
+	uint16_t reserved2;
+	int32_t lon0;
+	int32_t lat0;
+	int32_t lon1;
+	int32_t lat1;
+} ManifestEntry;
+
+/***************************************************************************************************
+	Type Definition: RouterExtent (Data Structure)
+	Description:
+		One visit to a quadrant, as stored in its RouterPage:
+		
+			addr:   DAT_ADDR of the visit's first record
+			count:  records the visit wrote, all of them in this quadrant
+			pages:  sectors those records span, from DAT_ADDR_SECTOR(addr) on
+			x0..y1: bounding box of its normal/super nodes [map units, quadrant frame; a node
+			        never strays more than MAPXBOUND/MAPYBOUND from the reference]
+			
+***************************************************************************************************/
+typedef struct {
+	uint32_t addr;
+	uint16_t count;
+	uint16_t pages;
+	int8_t x0;
+	int8_t y0;
+	int8_t x1;
+	int8_t y1;
+} RouterExtent;
+
 typedef struct {
+	int32_t originLat;				// Fix positions are measured from [1e-7 deg], moved a quadrant at a time
+	int32_t originLon;				// ...
+	uint32_t lastTime;				// Seconds of day of last UTC pane update
 	Vector2 ref;
 	Vector2 pos;
 	Vector2 sup;
 	Vector2 quad;
-	uint32_t startSector;
+	Vector2 view;					// Centre of the map pane from 'ref' [map units] (0 unless panning)
+	uint32_t startSector;			// First sector of the trace's quadrant directory
+	RouterExtent visit;				// Extent of the current visit, filled in as records are appended
+	uint32_t visitRouter;			// Router sector 'visit' is committed to on leaving the quadrant
+	uint8_t visitOpen;				// 'visit' is live
+	uint8_t visitNew;				// 'visitRouter' was allocated for this visit (nothing on the card yet)
+	ManifestEntry summary;			// Manifest entry of the trace, summarised as it is written
+	int32_t tripLon;				// Fix the trip statistics last counted from [1e-7 deg]
+	int32_t tripLat;				// ...
+	uint32_t tripTime;				// ...and its UTC time of day [0.01 s]
+	uint8_t tripFix;				// 'tripLon/Lat/Time' hold a fix of this trace
+	uint8_t tripMoving;				// Hundredths of a second of moving time not yet in 'summary'
+	uint8_t tripStopped;			// ...and of stopped time
 } TraceHandler; 
 
+/***************************************************************************************************
+	Type Definition: Superblock (Data Structure)
+	Description:
+		Layout of the signature sector, written when the card is formatted. A card is mounted
+		as is when its signature, version and geometry match this build's and its CRC
+		(CRC-16/CCITT of everything before it) holds; anything else gets formatted. Nothing
+		else decides it: where the card was left off comes from a checkpoint, or the manifest
+		when none is whole. Mounting loads the settings kept here, which are signed again
+		whenever one changes. Formatting only signs the card and clears the checkpoint ring
+		and first manifest sector, every other sector is set up as it is first handed out.
+		
+***************************************************************************************************/
+typedef struct {
+	char signature[4];				// SIG_SIGNATURE
+	uint8_t version;				// SIG_VERSION (layout of the sectors below)
+	uint8_t isPanOn;				// Settings: map panning
+	uint16_t sectorSize;			// DISK_SECTOR_SIZE
+	uint32_t manSector;				// MAN_SECTOR, MAN_BLOCKLEN, MAN_ENTRIES
+	uint16_t manBlocklen;			// ...
+	uint16_t manEntries;			// ...
+	uint32_t chkSector;				// CHK_SECTOR, CHK_BLOCKLEN
+	uint16_t chkBlocklen;			// ...
+	uint16_t reserved2;
+	uint32_t datSector;				// DAT_SECTOR
+	uint16_t crc;
+} Superblock;
+
+/***************************************************************************************************
+	Type Definition: Checkpoint (Data Structure)
+	Description:
+		Settings and trace state as of one checkpoint, a sector each in a ring of CHK_BLOCKLEN
+		from CHK_SECTOR (checkpoint 'seq' goes to sector CHK_SECTOR + seq % CHK_BLOCKLEN). 'crc'
+		(CRC-16/CCITT of everything after it) tells a whole record from a torn or stale one; the
+		whole record with the highest 'seq' is the state to resume from. Checkpoints are taken
+		before 'freeSector' can reach the last one's 'limit', so no sector from 'limit' on has
+		been handed out, and records appended since are found by following the live page on.
+		
+***************************************************************************************************/
+typedef struct {
+	uint8_t magic;
+	uint8_t reserved;
+	uint16_t crc;
+	uint32_t seq;
+	uint32_t limit;					// Sectors below it are, or may be, handed out
+	uint32_t prev;					// Page the live page continues from
+	SettingHandler settings;
+	TraceHandler trace;
+} Checkpoint;
+
+/***************************************************************************************************
+	Type Definition: NodeRecord (Data Structure)
+	Description:
+		Decoded node. On the card, nodes are stored compressed in a NodePage (see Node Stream):
+		
+			x, y: offset from the quadrant reference [map units] (normal/super nodes), or absolute
+			      longitude/latitude [1e-7 deg] (origin/reference nodes)
+			quad: quadrant the node was written in
+			dt:   seconds since the page's base time
+			type: DataType
+			
+***************************************************************************************************/
+typedef struct {
+	int32_t x;
+	int32_t y;
+	Vector2 quad;
+	uint16_t dt;
+	uint8_t type;
+	uint8_t reserved;
+} NodeRecord;
+
+/***************************************************************************************************
+	Type Definition: NodePage (Data Structure)
+	Description:
+		Layout of a node data sector. A 20 byte header is followed by the encoded node stream:
+		
+			time, date: UTC time/date the page was started at (base of every record's 'dt')
+			eid:        entry (trace) the page belongs to
+			magic:      DAT_PAGE_MAGIC once written (a wiped sector reads as 0)
+			count:      records in the stream
+			used:       bytes of 'body' in use
+			next:       sector the trace continues in once the page is full (0 while it isn't)
+			prev:       sector the trace came from (0 on its first page)
+			
+		Node Stream:
+			Every record starts with a tag byte (DataType | DAT_TAG_KEY), followed by zigzag
+			varints. Key records hold the whole node, delta records only the change from the
+			record before them:
+			
+				Key:   tag, quad.x, quad.y, x, y, dt
+				Delta: tag, x - x', y - y', dt - dt'
+				
+			The first record of a page is always a key, so any page decodes on its own. So are
+			super/origin/reference nodes and the first node in a new quadrant.
+			
+***************************************************************************************************/
+typedef struct {
+	uint32_t time;
+	uint16_t date;
+	uint16_t eid;
+	uint8_t magic;
+	uint8_t count;
+	uint16_t used;
+	uint32_t next;
+	uint32_t prev;
+	uint8_t body[492];				// DAT_PAGE_BODY
+} NodePage;
+
+/***************************************************************************************************
+	Type Definition: RouterPage (Data Structure)
+	Description:
+		Layout of a quadrant's router sector. Each visit to the quadrant appends its RouterExtent
+		when the quadrant is left (or the trace ends), so redrawing the quadrant reads exactly
+		the records that were written in it. 'gen' counts the records written to the quadrant; a
+		tile rendered at another generation is out of date.
+		
+***************************************************************************************************/
+typedef struct {
+	uint8_t magic;
+	uint8_t type;
+	uint16_t eid;
+	uint16_t count;
+	uint16_t gen;
+	RouterExtent ext[42];			// DAT_ROUTER_EXTENTS
+} RouterPage;
+
+/***************************************************************************************************
+	Type Definition: DirectoryPage (Data Structure)
+	Description:
+		Layout of a trace's quadrant directory sector: an open-addressed hash table (linear
+		probing from DAT_DIR_HASH) of the quadrants visited, and the router sector each was
+		given. A slot with router 0 is empty.
+		Sectors are chained through 'next'. New quadrants go into the first sector below
+		DAT_DIR_LOAD, and a sector is only added once the last one is that full, so a quadrant
+		missing from a sector with room is missing from the trace.
+		
+***************************************************************************************************/
+typedef struct {
+	int16_t qx;
+	int16_t qy;
+	uint32_t router;
+} DirectorySlot;
+
+typedef struct {
+	uint8_t magic;
+	uint8_t type;
+	uint16_t count;
+	uint32_t next;
+	DirectorySlot slot[63];			// DAT_DIR_SLOTS
+} DirectoryPage;
+
+/***************************************************************************************************
+	Type Definition: IndexPage (Data Structure)
+	Description:
+		Layout of a quadrant's index sector, the sector after its router. It lists where the
+		trace's normal/super nodes lie in the quadrant and which record holds each, so the
+		nodes near a point are found from one sector per quadrant without decoding node pages.
+		A node within DAT_INDEX_MERGE of one already listed isn't added (the same road driven
+		again adds nothing). Once DAT_INDEX_ENTRIES are listed, later nodes go to a sector
+		chained on through 'next', allocated from settings.freeSector.
+		
+***************************************************************************************************/
+typedef struct {
+	int8_t x;						// Offset from the quadrant reference [map units]
+	int8_t y;						// ...
+	uint32_t addr;					// DAT_ADDR of the node's record
+} IndexEntry;
+
+typedef struct {
+	uint8_t magic;
+	uint8_t type;
+	uint16_t count;
+	uint32_t next;					// Sector listing more of the quadrant's nodes (0 = none)
+	IndexEntry entry[84];			// DAT_INDEX_ENTRIES
+} IndexPage;
+
+/***************************************************************************************************
+	Type Definition: TilePage (Data Structure)
+	Description:
+		Header of a quadrant's tile, the sector after its index: the map pane as the quadrant's
+		visits render it (inside the pane border), run-length encoded. The runs fill 'bytes'
+		bytes of the sectors from 'data' on, one byte each. 'data' is one of the two tile areas
+		(DAT_TILE_AREA) that follow the header, each merge writing the one the tile isn't in:
+		
+			<P1><P0><L5><L4><L3><L2><L1><L0>
+			
+		Where P[1:0] picks a 'palette' color and L[5:0] + 1 is the run's length [px]. Runs go
+		row by row from the top-left pixel, carrying on across rows, so the pane is blitted
+		through one LCD window. A blank pane has no runs. A tile whose 'gen' isn't its router's
+		is redrawn from the nodes.
+		
+***************************************************************************************************/
+typedef struct {
+	uint8_t magic;
+	uint8_t type;
+	uint16_t gen;					// Router generation rendered
+	uint32_t data;					// First sector of runs: DAT_TILE_AREA 0 or 1
+	uint16_t bytes;					// Bytes of runs
+	uint16_t reserved;
+	Color palette[4];				// RGB565 color of each P[1:0]
+} TilePage;
+
+/***************************************************************************************************
+	Type Definition: TileNode (Data Structure)
+	Description:
+		A node of the open visit waiting to be painted into its quadrant's tile: offset from the
+		quadrant reference [map units] and DataType.
+		
+***************************************************************************************************/
+typedef struct {
+	int8_t x;
+	int8_t y;
+	uint8_t type;
+} TileNode;
+
+/***************************************************************************************************
+	Type Definition: IndexHit (Data Structure)
+	Description:
+		Result of an index query: a listed node's record and how far it lies from the query point.
+		
+***************************************************************************************************/
+typedef struct {
+	uint32_t addr;					// DAT_ADDR of the node's record
+	uint32_t dist2;					// Squared distance from the query point [map units^2]
+} IndexHit;
+
+/***************************************************************************************************
+	Type Definition: RetraceNode (Data Structure)
+	Description:
+		Node queued for retrace guidance, as a position in the stored trace's frame: map units
+		from its origin node, east/north positive.
+		
+***************************************************************************************************/
+typedef struct {
+	int32_t x;
+	int32_t y;
+	uint8_t type;
+} RetraceNode;
+
+/***************************************************************************************************
+	Type Definition: RetraceHandler (Data Structure)
+	Description:
+		State of the retrace engine (see Retrace Engine). Pages of the stored trace are staged
+		in disk.buff one at a time and decoded a block of records at a time into 'shared.ring', the
+		read-ahead the fix handler steers from. Once the live position strays from the queued
+		path, the quadrant index finds where the stream should pick up again.
+		
+***************************************************************************************************/
+typedef struct {
+	int32_t originLat;				// Stored trace's origin fix [1e-7 deg]
+	int32_t originLon;				// ...
+	uint32_t sector;				// Page being streamed
+	uint32_t directory;				// Stored trace's quadrant directory
+	uint16_t eid;					// Entry the pages must belong to
+	uint8_t forward;				// Stream order: 1 = as recorded, 0 = back to the origin
+	uint8_t loaded;					// 'sector' is staged in disk.buff
+	uint8_t ended;					// No pages left to stream
+	uint8_t mark;					// Forward: records of the page queued, reverse: records left
+	uint8_t seek;					// 'mark' to stage the next page at (0xFF: from its first/last record)
+	uint8_t probe;					// Fix handler lost the queued path: look 'live' up in the index
+	uint8_t offRoute;				// 1: index found nothing near 'live' either, 2: alert shown
+	Vector2 probeCell;				// RETRACE_CELL the index was last searched from (x = INT16_MAX: none)
+	RetraceNode live;				// Position posted by the fix handler
+	RetraceNode from;				// Last node passed (type 0xFF: none since the stream started)
+	uint8_t head;					// Ring index of the node being steered to
+	uint8_t count;					// Nodes in the ring
+	uint8_t lastRot;				// DIRB arrow drawn (10 degree steps, 0xFF = none)
+	Vector2 view;					// Quadrant shown in the map pane
+} RetraceHandler;
+
+/***************************************************************************************************
+	Type Definition: SharedBuffers (Union)
+	Description:
+		Buffers only one mode works in. RETRACING closes the visit before it opens a stored
+		trace, and a visit starts its pending counts from zero, so the read-ahead ring and the
+		open visit's pending index entries and tile nodes take the same SRAM.
+		
+***************************************************************************************************/
+typedef union {
+	RetraceNode ring[16];				// RETRACING: read-ahead (RETRACE_AHEAD)
+	struct {
+		IndexEntry indexPending[12];	// TRACING: index entries of the open visit not yet on the card (INDEX_PENDING)
+		TileNode tilePending[32];		// ...nodes of the open visit not yet painted into its tile (DAT_TILE_NODES)
+	};
+} SharedBuffers;
+
+/***************************************************************************************************
+	Type Definition: SimplifyHandler (Data Structure)
+	Description:
+		State of the streaming track simplifier between APP_update_trace and the node journal
+		(see Track Simplifier). Up to TRACE_WINDOW normal nodes are held back in the quadrant
+		frame of 'quad'; only the newest of them is ever stored.
+		
+***************************************************************************************************/
+typedef struct {
+	Vector2 anchor;					// Last node stored [map units, quadrant frame]
+	Vector2 quad;					// Quadrant of 'anchor' and the held points
+	uint8_t anchored;				// 'anchor' is valid
+	uint8_t count;					// Points held back
+	uint32_t heldTime;				// UTC time of the newest held point
+	Vector2 held[8];				// TRACE_WINDOW
+} SimplifyHandler;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //								    Application Public Functions								  //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -87,6 +480,12 @@ void APP_loadProgram_fast();
 void APP_loadProgram();
 void APP_startMode_debug();
 void APP_startMode_main();
+void APP_startMode_resume();
+void APP_startMode_retrace();
+void APP_startMode_follow();
+void APP_toggle_pan();
+void APP_service();
+void APP_flagUpdate();
 
 /* Debug GPS Functions */
 void APP_DGPS_setState(uint8_t state);
@@ -99,8 +498,17 @@ void APP_DGPS_setCourse(uint16_t course);
 uint8_t APP_formatCard();
 void APP_startMode_trace();
 void APP_update_trace();
+void APP_update_retrace();
 void APP_update_debug();
+#ifdef DEBUG
+void APP_benchmark_math();
+void APP_trips_today();
+#endif
 uint8_t APP_write_manifest(DataType type);
+uint8_t APP_close_manifest();
+uint8_t APP_manifest_get(uint16_t eid, ManifestEntry * entry);
+uint16_t APP_manifest_find_time(uint32_t stamp);
+uint16_t APP_manifest_find_region(int32_t lon, int32_t lat);
 uint8_t APP_write_node(DataType type);
 uint8_t APP_write_router();
 void APP_reDrawMapPane();
@@ -111,10 +519,32 @@ void APP_reDrawMapPane();
 /* Control Parameters */
 extern SettingHandler settings;
 #define MASTERUPDATETIME 100
+#define TRACE_PERIOD 1				// Trace writer period [s], decimation follows the GPS output rate
+#define RATE_WALK_UP 250			// Tracing: 1 Hz -> 5 Hz at or above [cm/s] (9 km/h)
+#define RATE_WALK_DOWN 150			// Tracing: 5 Hz -> 1 Hz below [cm/s]
+#define RATE_DRIVE_UP 1000			// Tracing: -> 10 Hz at or above [cm/s] (36 km/h)
+#define RATE_DRIVE_DOWN 700			// Tracing: 10 Hz -> 5 Hz below [cm/s]
+#define TRACE_TOLERANCE_CM 50		// Simplifier error budget [cm]
+#define TRACE_WINDOW 8				// Simplifier: most normal nodes held back at once
+#define RETRACE_AHEAD 16			// Retrace: nodes read ahead
+#define RETRACE_BLOCK 8				// Retrace: nodes decoded per main loop pass
+#define RETRACE_REACH 16			// Retrace: node counts as reached within [map units] (3 m)
+#define RETRACE_OFFROUTE 40			// Retrace: off route beyond [map units] of the path (7 m)
+#define RETRACE_CELL 4				// Retrace: off route, the index is searched once per 2^n map units square (3 m)
+#define RETRACE_HITS 4				// Retrace: nearest indexed nodes weighed when picking the stream up again
+#define INDEX_PENDING 12			// Index entries buffered in RAM before merging into the card
 #define TIMER0_NE6 64E6
 #define D2PX 1
 #define MAPXBOUND (NAVSCREEN_MAP_PANEW / 2)
 #define MAPYBOUND (NAVSCREEN_MAP_PANEH / 2)
+#define MAPPANSTEP (NAVSCREEN_MAP_PANEW / 4)	// Distance from the view's centre that pans the view
+#define APP_FIX2POS(d) ((d) * 3 / 50)		// Fix offset [1e-7 deg] -> position [1e-4 arcmin]
+#define APP_POS2FIX(p) ((int32_t)(p) * 50 / 3)	// Position [1e-4 arcmin] -> fix offset [1e-7 deg]
+#define APP_CM2POS(c) ((c) * 54 / 1000)	// Distance [cm] -> position [1e-4 arcmin = 18.52 cm], rounded down
+#define APP_FIX2CM(d) (((d) >> 8) * 285 + ((((d) & 255) * 285) >> 8))	// Fix offset [1e-7 deg of latitude] -> distance [cm] (1.1132)
+#define TRIP_MOVING 50				// Trip: moving at or above [cm/s] (slower steps are fix jitter)
+#define TRIP_GAP 10					// Trip: longer intervals between fixes add their distance only [s]
+#define APP_TRIP_AVERAGE(e) ((e)->moving ? (e)->distance / (e)->moving : 0)	// Mean moving speed [cm/s]
 
 /* Trace Parameters */
 #define NODECOLOR_NORMAL WHITE
@@ -122,8 +552,6 @@ extern SettingHandler settings;
 #define NODECOLOR_USER   RED
 #define NODESIZE		 4
 #define NODESIZE_S		 2
-#define QUAD_COLCOUNT    32
-#define QUAD_ROWCOUNT    32
 
 /* Set Loading Screen Parameters */
 #define LOADSCREEN_SCREENCOLOR BLACK
@@ -139,40 +567,57 @@ extern SettingHandler settings;
 /* Signature Parameters */
 #define SIG_SECTOR			0
 #define SIG_BLOCKLEN		1
-#define SIG_TOTAL_SIZE		(1 + 1)
+#define SIG_SIGNATURE		"&^K"			// Same as the MCU's EEPROM signature
+#define SIG_VERSION			3				// Bump whenever the card layout changes
+#define SIG_CRC_SIZE		offsetof(Superblock,crc)	// Superblock bytes covered by 'crc'
 /* Manifest Parameters */
 #define MAN_SECTOR			(0 + SIG_SECTOR + SIG_BLOCKLEN)
 #define MAN_BLOCKLEN		255
-#define MAN_TYPE_OFF		0
-#define MAN_TYPE_SIZE		(1 + 1)
-#define MAN_START_OFF		(MAN_TYPE_OFF + MAN_TYPE_SIZE)
-#define MAN_START_SIZE		(8 + 1)
-#define MAN_END_OFF			(MAN_START_OFF + MAN_START_SIZE)
-#define MAN_END_SIZE		(8 + 1)
-#define MAN_TOTAL_SIZE		(MAN_TYPE_SIZE + MAN_START_SIZE + MAN_END_SIZE)
+#define MAN_ENTRIES			(DISK_SECTOR_SIZE / sizeof(ManifestEntry))	// 8
+#define MAN_ENTRY_SECTOR(e)	(MAN_SECTOR + ((e) - 1) / MAN_ENTRIES)
+#define MAN_ENTRY_SLOT(e)	(((e) - 1) % MAN_ENTRIES)
+#define APP_STAMP(d,t)		((((uint32_t)GPS_DATE_YEAR(d) * 12 + GPS_DATE_MONTH(d) - 1) * 31 + GPS_DATE_DAY(d) - 1) \
+							* GPS_SECONDS_PER_DAY + (t))		// Date/time -> seconds, ordered
+/* Checkpoint Parameters */
+#define CHK_SECTOR			(0 + MAN_SECTOR + MAN_BLOCKLEN)
+#define CHK_BLOCKLEN		4
+#define CHK_CRC_FROM		4				// Checkpoint bytes covered by 'crc' start at 'seq'
+#define CHK_RESERVE			256				// Sectors a checkpoint lets be handed out past 'freeSector'
+#define CHK_SLACK			128				// Checkpoint again once fewer are left (more than a page, router and tile take)
 /* Database Parameters */
-#define DAT_SECTOR			(0 + MAN_SECTOR + MAN_BLOCKLEN)
-#define DAT_TYPE_OFF		0
-#define DAT_TYPE_SIZE		(1 + 1)
-#define DAT_EID_OFF			(DAT_TYPE_OFF + DAT_TYPE_SIZE)
-#define DAT_EID_SIZE		(3 + 1)
-/* Node Specific Parameters */
-#define DAT_X_OFF			(DAT_EID_OFF + DAT_EID_SIZE)
-#define DAT_X_SIZE			GPS_BYTES_ASCII_LONGITUDE
-#define DAT_Y_OFF			(DAT_X_OFF + DAT_X_SIZE)
-#define DAT_Y_SIZE			GPS_BYTES_ASCII_LATITUDE
-#define DAT_TIME_OFF		(DAT_Y_OFF + DAT_Y_SIZE)
-#define DAT_TIME_SIZE		GPS_BYTES_ASCII_UTC_TIME
-#define DAT_DATE_OFF		(DAT_TIME_OFF + DAT_TIME_SIZE)
-#define DAT_DATE_SIZE		GPS_BYTES_ASCII_UTC_DATE
-#define DAT_QUADC_OFF		(DAT_DATE_OFF + DAT_DATE_SIZE)
-#define DAT_QUADC_SIZE		(3 + 1)
-#define DAT_QUADR_OFF		(DAT_QUADC_OFF + DAT_QUADC_SIZE)
-#define DAT_QUADR_SIZE		(3 + 1)
-#define DAT_NODE_SIZE		(DAT_TYPE_SIZE + DAT_EID_SIZE  + DAT_X_SIZE + DAT_Y_SIZE + DAT_TIME_SIZE + DAT_DATE_SIZE + DAT_QUADC_SIZE + DAT_QUADR_SIZE)
+#define DAT_SECTOR			(0 + CHK_SECTOR + CHK_BLOCKLEN)
+#define DAT_PAGE_MAGIC		0xA5
+#define DAT_PAGE_HEADER		20
+#define DAT_PAGE_BODY		(DISK_SECTOR_SIZE - DAT_PAGE_HEADER)		// 492
+#define DAT_TAG_KEY			0x80			// Record holds the whole node (restart point)
+#define DAT_TAG_TYPE		0x0F
+#define DAT_RECORD_MAX		(1 + 3 + 3 + 5 + 5 + 3)					// Largest key record
+/* Node Addresses (Sector + Record Index) */
+#define DAT_ADDR(sec,i)		(((uint32_t)(sec) << 8) | (i))
+#define DAT_ADDR_SECTOR(a)	((a) >> 8)
+#define DAT_ADDR_INDEX(a)	((uint8_t)(a))
 /* Router Specific Parameters */
-#define DAT_ADDRN_OFF		(DAT_EID_OFF + DAT_EID_SIZE)
-#define DAT_ADDRN_SIZE		(8 + 1)
-#define DAT_ROUTER_SIZE		(DAT_TYPE_SIZE + DAT_EID_SIZE + DAT_ADDRN_SIZE * 8)
+#define DAT_ROUTER_HEADER	8
+#define DAT_ROUTER_EXTENTS	((DISK_SECTOR_SIZE - DAT_ROUTER_HEADER) / sizeof(RouterExtent))	// 42
+#define DAT_ROUTER_SECTORS	(3 + 2 * DAT_TILE_SECTORS)				// Router, index, tile header and tile areas
+#define DAT_REDRAW_BATCH	4				// Extents copied out of the router per read (on the stack)
+/* Directory Specific Parameters */
+#define DAT_DIR_HEADER		8
+#define DAT_DIR_SLOTS		((DISK_SECTOR_SIZE - DAT_DIR_HEADER) / sizeof(DirectorySlot))	// 63
+#define DAT_DIR_LOAD		48				// Slots used before a sector counts as full
+#define DAT_DIR_HASH(q)		(((uint16_t)(q).x * 181u + (uint16_t)(q).y * 59u) % DAT_DIR_SLOTS)
+/* Tile Specific Parameters */
+#define DAT_TILE_W			(NAVSCREEN_MAP_PANEW - 2)				// Pane inside its border [px]
+#define DAT_TILE_H			(NAVSCREEN_MAP_PANEH - 2)				// ...
+#define DAT_TILE_ROWBYTES	((DAT_TILE_W + 3) / 4)					// 2 bits per pixel
+#define DAT_TILE_RUN		64				// Longest run [px]
+#define DAT_TILE_NODES		32				// Nodes held back before they are painted into the tile
+#define DAT_TILE_SECTORS	8				// Sectors of runs each tile area holds (a busier tile isn't kept)
+#define DAT_TILE_BYTES		(DAT_TILE_SECTORS * DISK_SECTOR_SIZE)
+#define DAT_TILE_AREA(r,i)	((r) + 3 + (i) * DAT_TILE_SECTORS)		// Tile area 0/1 of router 'r'
+/* Index Specific Parameters */
+#define DAT_INDEX_HEADER	8
+#define DAT_INDEX_ENTRIES	((DISK_SECTOR_SIZE - DAT_INDEX_HEADER) / sizeof(IndexEntry))		// 84
+#define DAT_INDEX_MERGE		3				// Nodes closer than this to a listed one are skipped [map units]
 
 #endif
\ No newline at end of file
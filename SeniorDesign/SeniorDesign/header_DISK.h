@@ -45,16 +45,20 @@ typedef enum{
 		
 			type:       card type found during initialization
 			lastSector: last sector that was written to or read from
-			buff:       SRAM stored buffer for transmitting to and from card
+			buff:       SRAM stored buffer for transmitting to and from card (one whole sector, so
+			            binary pages can be read, modified and written back in place)
 			buffIt:		current index of buffer based on loading data
+			streamLeft: bytes left of the block read DISK_stream_open left open (0 = none)
 		
 ***************************************************************************************************/
-#define BUFFMAXBYTES 78
+#define DISK_SECTOR_SIZE 512
+#define BUFFMAXBYTES DISK_SECTOR_SIZE
 typedef struct{
 	DISKType type;
 	uint16_t lastSector;
 	char buff[BUFFMAXBYTES];
-	uint8_t buffIt;
+	uint16_t buffIt;
+	uint16_t streamLeft;
 	
 } DISKHandler;
 extern DISKHandler disk;
@@ -97,6 +101,13 @@ void DISK_loadBuff_str(char * data, uint8_t off);
 ***************************************************************************************************/
 void DISK_loadBuff_int(int data, uint8_t off);
 
+/***************************************************************************************************
+	Function: loadBuff_long
+		- Loads buffer with long integer 'data' at 'off'
+		
+***************************************************************************************************/
+void DISK_loadBuff_long(int32_t data, uint8_t off);
+
 /***************************************************************************************************
 	Function: write
 		- Writes buffer into 'sector'.
@@ -113,6 +124,41 @@ uint8_t DISK_write(uint32_t sector);
 ***************************************************************************************************/
 uint8_t DISK_read(uint32_t sector);
 
+/***************************************************************************************************
+	Function: read_part
+		- Reads 'len' bytes from 'offset' of 'sector' into 'dst', leaving the buffer as it is.
+		! sector <  16777216
+		! offset + len <= 512
+		
+***************************************************************************************************/
+uint8_t DISK_read_part(uint32_t sector, uint16_t offset, uint8_t * dst, uint16_t len);
+
+/***************************************************************************************************
+	Function: stream_open
+		- Starts reading 'sector' from 'offset', leaving the card selected so its bytes can be
+		  taken one at a time (DISK_stream_byte) without a buffer. Any other card command first
+		  clocks the rest of the block out; nothing else may use the SPI bus while it is open.
+		! sector <  16777216
+		! offset <  512
+		
+***************************************************************************************************/
+uint8_t DISK_stream_open(uint32_t sector, uint16_t offset);
+
+/***************************************************************************************************
+	Function: stream_byte
+		- Returns the next byte of the open read, closing it after the block's last byte.
+		! disk.streamLeft > 0
+		
+***************************************************************************************************/
+uint8_t DISK_stream_byte();
+
+/***************************************************************************************************
+	Function: stream_close
+		- Clocks past the rest of the open read (if any) and releases the card.
+		
+***************************************************************************************************/
+void DISK_stream_close();
+
 /***************************************************************************************************
 	Function: wipe
 		- Fills 'count' blocks starting from 'sector' with NULL characters
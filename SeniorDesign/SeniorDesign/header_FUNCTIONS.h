@@ -15,18 +15,34 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /* FROM GPS */
-//Max Length of NMEA Sentence
-#define GPS_BUFFER_MAX 100 
+//Size of USART receive ring (MUST be a power of two, no larger than 256):
+#define GPS_RING_SIZE 128
+#define GPS_RING_MASK (GPS_RING_SIZE - 1)
 
-//Lengths of ASCII Parameters:			SIGN	LEN		TERMINATOR
-#define GPS_BYTES_ASCII_UTC_TIME		(0 +	8 +		1)
-#define GPS_BYTES_ASCII_UTC_DATE		(0 +	8 +		1)
-#define GPS_BYTES_ASCII_LATITUDE		(1 +	8 +		1)
-#define GPS_BYTES_ASCII_LONGITUDE		(1 +	9 +		1)
-#define GPS_BYTES_ASCII_COURSE			(0 +	3 +		1)
-#define GPS_BYTES_ASCII_SPEED			(0 +	1 +		1)
+//Slots in the USART transmit queue (MUST be a power of two, one slot always stays free):
+#define GPS_CMD_SLOTS 4
+#define GPS_CMD_MASK (GPS_CMD_SLOTS - 1)
 
-#define GPS_BYTES_ASCII_TOTAL			(GPS_BYTES_ASCII_UTC_TIME + GPS_BYTES_ASCII_UTC_DATE + GPS_BYTES_ASCII_LATITUDE + GPS_BYTES_ASCII_LONGITUDE + GPS_BYTES_ASCII_COURSE + GPS_BYTES_ASCII_SPEED + 4)
+//Lengths of ASCII Strings Generated For Display:	SIGN	LEN		TERMINATOR
+#define GPS_ASCII_TIME					(0 +	8 +		1)		// hh:mm:ss
+#define GPS_ASCII_DATE					(0 +	8 +		1)		// dd/mm/yy
+#define GPS_ASCII_COORD					(0 +	10 +	1)		// ddd.dddddH
+#define GPS_ASCII_DECIMAL				(1 +	11 +	1)		// -2147483.648
+
+//Fixed-point scales of the binary fix:
+#define GPS_COORD_SCALE					10000000L			// Coordinates: [1e-7 deg]
+#define GPS_COURSE_SCALE				100					// Course: [0.01 deg]
+#define GPS_SECONDS_PER_DAY				86400UL
+
+//Thresholds for a fix worth logging (see GPS_fix_usable):
+#define GPS_LOG_MIN_SATELLITES			4
+#define GPS_LOG_MAX_HDOP				500					// HDOP 5.00
+
+//Packed date: <y6>...<y0><m3>...<m0><d4>...<d0> (years since 2000)
+#define GPS_DATE_PACK(d,m,y)			((uint16_t)(((uint16_t)(y) << 9) | ((uint16_t)(m) << 5) | (d)))
+#define GPS_DATE_DAY(p)					((p) & 0x1F)
+#define GPS_DATE_MONTH(p)				(((p) >> 5) & 0x0F)
+#define GPS_DATE_YEAR(p)				((p) >> 9)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //								SYSTEM VARIABLES/FUNCTIONS    									  //
@@ -47,9 +63,60 @@ void SD_SPI_save_coordinate(char type);
 void SD_format_card(void);
 
 /* FROM GPS DRIVER */
-unsigned char GPS_BUFFER[GPS_BUFFER_MAX];
-unsigned char GPS_BUFFER_INDEX;
-unsigned char GPS_MESSAGE_READY;
+/* USART RECEIVE RING */
+//Single-producer/single-consumer byte ring. ISR(USART0_RX_vect) is the only writer of 'head'
+//and GPS_service() is the only writer of 'tail', so neither side needs to disable interrupts.
+typedef struct{
+	unsigned char buff[GPS_RING_SIZE];
+	volatile uint8_t head;				//Next free slot (producer)
+	volatile uint8_t tail;				//Next unread slot (consumer)
+	volatile uint16_t overruns;			//Bytes dropped because the ring was full
+	volatile uint16_t hw_overruns;		//Bytes lost in UDR0 before the ISR could read them (DOR0)
+} GPS_ring;
+extern GPS_ring GPS_RX;
+
+/* USART TRANSMIT QUEUE */
+//PMTK commands are queued by pointer into program memory and never copied. ISR(USART0_UDRE_vect)
+//sends them back to back and is the only writer of 'send'/'next'; the main loop adds commands at
+//'head' and retires them from 'tail' as their $PMTK001 replies arrive. A slot is only reused once
+//its command has been acknowledged (or given up on).
+typedef enum{
+	GPS_ACK_INVALID,					//$PMTK001 flag 0: invalid command
+	GPS_ACK_UNSUPPORTED,				//              1: unsupported command
+	GPS_ACK_FAILED,						//              2: valid command, action failed
+	GPS_ACK_OK,							//              3: valid command, action succeeded
+	GPS_ACK_LOST						//No reply (timed out, or a later command was answered)
+} GPS_ack;
+
+typedef void (*GPS_ack_handler)(uint16_t id, GPS_ack result);
+
+typedef struct{
+	const unsigned char * cmd;			//NUL-terminated PROGMEM command
+	GPS_ack_handler done;				//Called with the result (may be 0)
+	uint16_t id;						//PMTK packet type, matched against the reply
+} GPS_cmd;
+
+typedef struct{
+	GPS_cmd slot[GPS_CMD_SLOTS];
+	const unsigned char * next;			//Next byte of the command on the wire (0 = not started)
+	volatile uint8_t head;				//Next free slot (main loop)
+	volatile uint8_t send;				//Next slot to transmit (ISR)
+	uint8_t tail;						//Oldest slot awaiting its reply (main loop)
+	uint8_t age;						//Epochs the oldest sent command has waited
+} GPS_tx_queue;
+extern GPS_tx_queue GPS_TX;
+
+uint8_t GPS_queue_P(const unsigned char * cmd, GPS_ack_handler done);
+
+/* SENTENCE COUNTERS */
+//Tallied by the parser once the trailing checksum of a sentence has been checked:
+typedef struct{
+	uint16_t good;						//Sentences whose checksum matched
+	uint16_t bad;						//Sentences discarded for a wrong or malformed checksum
+	uint16_t nacks;						//PMTK commands rejected or never acknowledged
+} GPS_counters;
+extern GPS_counters GPS_STATS;
+
 void GPS_init_USART(uint16_t UBRR);
 void GPS_enable_stream(void);
 void GPS_disable_stream(void);
@@ -60,37 +127,80 @@ void GPS_parse_data(void);
 void GPS_configure_firmware(void);
 void GPS_USART_Transmit(unsigned char data);
 void GPS_TX_PARSE_ERROR(void);
-//10-20-2018
-void GPS_request_update(void);
-uint8_t GPS_parse_V3(void);
 //11-27-2018
 uint8_t GPS_parse();
+//Main-loop consumer of GPS_RX and the streaming parser it feeds:
+void GPS_service(void);
+void GPS_parse_byte(char data);
+//ASCII generation for screens:
+void GPS_format_time(uint32_t time, char * str);
+void GPS_format_date(uint16_t date, char * str);
+void GPS_format_coord(int32_t coord, char pos, char neg, char * str);
+void GPS_format_decimal(int32_t val, uint8_t decimals, char * str);
 
 //Variables:
+/* ACCEPTED SENTENCES */
+//Index into the parser's dispatch table:
+typedef enum{
+	GPS_NMEA_RMC,
+	GPS_NMEA_GGA,
+	GPS_NMEA_GSA,
+	GPS_NMEA_VTG,
+	GPS_NMEA_ACK,					//$PMTK001 command acknowledgment
+	GPS_NMEA_COUNT
+} GPS_sentence;
+
+//Sentences that complete an epoch (published together as one fix):
+#define GPS_NMEA_EPOCH		((1 << GPS_NMEA_RMC) | (1 << GPS_NMEA_GGA))
+
 /* GPS CURRENT READINGS DATA STRUCTURE */
+//Binary fixed-point fix, decoded once at ingest. ASCII is only generated (GPS_format_*) by the
+//screens that print it.
 typedef struct{
 	
-	char UTC_TIME_ASCII[GPS_BYTES_ASCII_UTC_TIME];		// hh:mm:ss.sss
-	char UTC_TIME_ASCII_LAST[GPS_BYTES_ASCII_UTC_TIME];
-	
-	char UTC_DATE_ASCII[GPS_BYTES_ASCII_UTC_DATE];		// dd/mm/yy
-	
-	char LATITUDE_ASCII[GPS_BYTES_ASCII_LATITUDE];		// 1234.6789
-	char LATITUDE_ASCII_LAST[GPS_BYTES_ASCII_LATITUDE];
-	
-	char LONGITUDE_ASCII[GPS_BYTES_ASCII_LONGITUDE];	// -12345.7890__
-	char LONGITUDE_ASCII_LAST[GPS_BYTES_ASCII_LONGITUDE];
-	
-	char SPEED_ASCII[GPS_BYTES_ASCII_SPEED];			// 23.2
-	char COURSE_ASCII[GPS_BYTES_ASCII_COURSE];		// 259.00, 34.12
+	int32_t LATITUDE;				// [1e-7 deg], north positive
+	int32_t LONGITUDE;				// [1e-7 deg], east positive
+	uint32_t UTC_TIME;				// Seconds of day (UTC)
+	uint8_t UTC_CENTI;				// ...and hundredths of the second (5/10 Hz fixes share one)
+	uint16_t UTC_DATE;				// GPS_DATE_PACK(dd,mm,yy)
+	uint16_t SPEED;					// Ground speed [cm/s]
+	uint16_t COURSE;				// Course over ground [0.01 deg]
+	int32_t ALTITUDE;				// Altitude above mean sea level [cm]
+	uint16_t HDOP;					// Horizontal dilution of precision [0.01]
+	uint8_t QUALITY;				// GGA fix quality (0 = no fix)
+	uint8_t SATELLITES;				// Satellites used in fix
+	uint8_t FIX_TYPE;				// GSA fix type (1 = none, 2 = 2D, 3 = 3D)
 	char STATUS;					// A
-	char NS;						// N
-	char EW;						// W
-	
-	char IS_PROCESSING;				//Value is 1 if a data is being processed.
+	uint8_t EPOCH;					// Publication count (wraps), changes with every new fix
 	
 } GPS_data;
-extern GPS_data SYS_GPS;
+
+//Copy of the latest fix (main loop only), and its quality check:
+uint8_t GPS_snapshot(GPS_data * dst);
+uint8_t GPS_fix_usable(const GPS_data * fix);
+
+/* FIX SUBSCRIBERS */
+//Handlers called by GPS_service() with each 'every'-th published fix. The receiver streams
+//continuously, so a fix reaches its subscribers as soon as the sentence completing its epoch has
+//been drained from GPS_RX.
+#define GPS_SUBSCRIBER_MAX	2
+typedef void (*GPS_handler)(const GPS_data * fix);
+uint8_t GPS_subscribe(GPS_handler handler, uint8_t every);
+void GPS_set_decimation(GPS_handler handler, uint8_t every);
+
+/* OUTPUT RATE */
+//Fix/output rates the application can switch between at run time. Requests are capped to what
+//the negotiated link carries, and the PMTK commands go out in the background from GPS_service().
+typedef enum{
+	GPS_RATE_1HZ,
+	GPS_RATE_5HZ,
+	GPS_RATE_10HZ,
+	GPS_RATE_COUNT
+} GPS_rate;
+
+#define GPS_RATE_HZ(r)		((r) == GPS_RATE_1HZ ? 1 : (r) == GPS_RATE_5HZ ? 5 : 10)
+GPS_rate GPS_set_rate(GPS_rate rate);
+GPS_rate GPS_get_rate(void);
 
 /* FROM EEPROM */
 //Persistent (EEPROM-buffered) data:
@@ -4,9 +4,13 @@
 //									          Keypad Header										  //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //Screen option count:
-#define OPTION_LENGTH_MAIN	3
+#ifdef DEBUG
+#define OPTION_LENGTH_MAIN	6
+#else
+#define OPTION_LENGTH_MAIN	5
+#endif
 #define OPTION_LENGTH_NAV	2
-#define OPTION_LENGTH_TRACE	4
+#define OPTION_LENGTH_TRACE	5
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //											     Library										  //
@@ -22,6 +26,8 @@
 	Description:
 		Defines a 'task' to be performed and its corresponding option 'label'.
 		Lists of options are externally available and are easily modifiable within the driver.
+		The lists are kept in flash (PROGMEM): read 'task' with pgm_read_word and print 'label'
+		with the LCD's '_P' functions.
 			
 ***************************************************************************************************/
 typedef const struct{
@@ -54,12 +60,21 @@ void KEY_setState(uint8_t state);
 
 /***************************************************************************************************
 	Function: execute
-		- Calls a task based on the global state of the system
+		- Latches a task based on the global state of the system (run later by 'service')
 		! This function is handled by an interrupt
 		
 ***************************************************************************************************/
 void KEY_execute();
 
+/***************************************************************************************************
+	Function: service
+		- Runs the task latched by 'execute', if any
+		! This function is called from the main loop, so tasks may block without stalling the
+		  GPS receiver
+		
+***************************************************************************************************/
+void KEY_service();
+
 /***************************************************************************************************
 	Function: scroll
 		- Moves cursor on screen and updates global state of the system
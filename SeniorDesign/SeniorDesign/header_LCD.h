@@ -10,7 +10,6 @@
 #include <avr/io.h>
 #include <string.h>
 #include <stdlib.h>
-#include <math.h>
 #define F_CPU 8E6
 #include "util/delay.h"
 #include "header_KEYPAD.h"
@@ -156,6 +155,23 @@ void LCD_drawRect_filled (uint16_t x, uint16_t y, uint16_t w, uint16_t h, Color
 ***************************************************************************************************/
 void LCD_drawRect_empty (uint16_t x, uint16_t y, uint16_t w, uint16_t h, Color color);
 
+/***************************************************************************************************
+	Function: openWindow
+		- Selects the 'w' x 'h' [px] zone at pivot-coordinates ('x','y') [PIVOT = TOPLEFT] for
+		  pushRun, which fills it row by row from the top-left corner.
+		
+***************************************************************************************************/
+void LCD_openWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+
+/***************************************************************************************************
+	Function: pushRun
+		- Sends 'count' pixels of 'color' into the zone selected by openWindow, holding chip
+		  select for the whole run.
+		! Nothing else may be drawn until the zone is filled (it would move the zone)
+		
+***************************************************************************************************/
+void LCD_pushRun(Color color, uint16_t count);
+
 /***************************************************************************************************
 	Function: drawCircle_filled	
 		- Draws 'color'-colored filled circle at pivot-coordinates ('x0','y0') [PIVOT = CENTER]
@@ -240,11 +256,13 @@ void LCD_moveCursor(int16_t spaces, int16_t lines);
 		- Prints text according to text handler ('setText_[parameters](parameters)'). The cursor
 		  will be automatically moved horizontally.
 		- '\n' will move cursor to next line, according to the text handler's xorigin
+		- '_P' takes a string kept in flash (PSTR/PROGMEM), so literals cost no SRAM
 		! If end of screen is reached, text will NOT go to next line.
 		
 ***************************************************************************************************/
 void LCD_print_char(char c);
 void LCD_print_str(char * str);
+void LCD_print_str_P(const char * str);
 void LCD_print_str_len(char * str, uint8_t len);
 void LCD_print_int(int num);
 
@@ -258,6 +276,7 @@ void LCD_print_int(int num);
 ***************************************************************************************************/
 void LCD_println_char(char c);
 void LCD_println_str(char * str);
+void LCD_println_str_P(const char * str);
 void LCD_println_str_len(char * str, uint8_t len);
 void LCD_println_int(int num);
 
@@ -371,6 +390,8 @@ void LCD_setIconState(OutlineImage type, uint8_t state);
 #define MAINSCREEN_OPTION_SIZE		MAINSCREEN_TEXT_SIZE
 #define MAINSCREEN_OPTION_COLOR		MAINSCREEN_TEXT_COLOR
 #define MAINSCREEN_OPTION_COUNT		OPTION_LENGTH_MAIN
+#define MAINSCREEN_TRIPS_Y			(MAINSCREEN_OPTION_Y + (OPTION_LENGTH_MAIN + 1) * 8 * MAINSCREEN_OPTION_SIZE)
+#define MAINSCREEN_TRIPS_LINES		8
 
 /* Set Debug Screen Parameters */
 #define DEBUGSCREEN_SCREENCOLOR		BLACK
@@ -388,6 +409,7 @@ void LCD_setIconState(OutlineImage type, uint8_t state);
 #define DEBUGSCREEN_OPTION_SIZE		DEBUGSCREEN_TEXT_SIZE
 #define DEBUGSCREEN_OPTION_COLOR	YELLOW
 #define DEBUGSCREEN_OPTION_COUNT	OPTION_LENGTH_NAV
+#define DEBUGSCREEN_BENCH_X			(DEBUGSCREEN_OPTION_X + (16 * 6 * DEBUGSCREEN_OPTION_SIZE))
 
 /* Set Navigation Screen Parameters */
 #define NAVSCREEN_MAP_PANECOLOR		RED
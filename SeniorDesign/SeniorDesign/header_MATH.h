@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//											MATH HEADER											  //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifndef HEADER_MATH_H
+#define HEADER_MATH_H
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//										   MATH Libraries										  //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <stdlib.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//										 MATH Definitions										  //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#define MATH_ONE 32767					// 1.0 in the Q15 results of 'sin'/'cos'
+#define MATH_ATAN_STEPS 32				// Rows of the first octant's atan table (tan = 0..1)
+#define MATH_ATAN_SCALE 10				// Atan table: [0.1 deg]
+#define MATH_BENCH_RUNS 64				// Benchmark: arguments each kernel is timed over
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//									   MATH Type Definitions									  //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************************************
+	Type Definition: MathBench (Data Structure)
+	Description:
+		Cost of a MATH_ kernel and of the float expression it replaced, per call [cycles]
+		
+***************************************************************************************************/
+typedef enum {
+	MATH_BENCH_SIN,					// MATH_sin				sin(deg * pi / 180)
+	MATH_BENCH_COS,					// MATH_cos				cos(deg * pi / 180)
+	MATH_BENCH_ATAN2,				// MATH_atan2			atan2(y, x) * 180 / pi
+	MATH_BENCH_HYPOT,				// MATH_hypot			sqrt(dx * dx + dy * dy)
+	MATH_BENCH_COUNT
+} MathKernel;
+
+typedef struct {
+	uint16_t fixed;					// MATH_ kernel
+	uint16_t real;					// Float counterpart
+} MathBench;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//										MATH Public Functions									  //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************************************
+	Function: sin / cos
+		- Sine and cosine of a whole angle 'deg' [deg], any sign or size
+		- Returns Q15: -MATH_ONE .. MATH_ONE
+		- Read from a quarter wave table in flash, no floating point
+
+***************************************************************************************************/
+int16_t MATH_sin (int16_t deg);
+int16_t MATH_cos (int16_t deg);
+
+/***************************************************************************************************
+	Function: cos_frac
+		- Cosine of 'deg' + 'frac'/256 [deg] for 'deg' 0..90, linearly interpolated (Q15)
+		- Use for cos(latitude), where a whole degree is too coarse
+
+***************************************************************************************************/
+uint16_t MATH_cos_frac (uint8_t deg, uint8_t frac);
+
+/***************************************************************************************************
+	Function: atan2
+		- Angle of the vector ('x','y') [deg]: 0..359, counter-clockwise from +x
+		- Returns 0 for the zero vector (no division is ever made by a zero 'x')
+		- Octant folded onto a flash table of tan = 0..1 and interpolated: the whole degree returned
+		  is within 0.65 deg of the exact angle
+
+***************************************************************************************************/
+uint16_t MATH_atan2 (int32_t y, int32_t x);
+
+/***************************************************************************************************
+	Function: bearing
+		- Compass bearing of the offset ('dx' east, 'dy' north) [deg]: 0..359, clockwise from north
+		- Returns 0 for the zero offset
+
+***************************************************************************************************/
+uint16_t MATH_bearing (int32_t dx, int32_t dy);
+
+/***************************************************************************************************
+	Function: isqrt
+		- Integer square root (floor) of 'val', a result bit per round
+
+***************************************************************************************************/
+uint16_t MATH_isqrt (uint32_t val);
+
+/***************************************************************************************************
+	Function: hypot
+		- Length of the offset ('dx','dy') in its own units
+		- Exact below 0x7FFF per axis, longer offsets are scaled down first (relative error < 2e-4)
+
+***************************************************************************************************/
+uint32_t MATH_hypot (int32_t dx, int32_t dy);
+
+#ifdef DEBUG
+/***************************************************************************************************
+	Function: benchmark
+		- Times each kernel and its float counterpart on Timer 1 (N = 1: one count per cycle),
+		  averaged over MATH_BENCH_RUNS arguments swept over their range, into 'bench' (by MathKernel)
+		- Call overhead is measured alone and taken off, interrupts are held off around each call
+		- Borrows Timer 1 from the buzzer: silences any tone and restores the timer's mode after
+		- Debug build only (pulls in the float library)
+
+***************************************************************************************************/
+void MATH_benchmark (MathBench * bench);
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#endif
@@ -20,7 +20,8 @@
 		4. GPS - Adafruit Ultimate GPS Breakout
 			- Transmits GPS information to MCU via USART
 				
-	- After initialization is complete, the MCU enters standby mode, waiting for interrupts
+	- After initialization is complete, the MCU enters the main loop, which services work deferred
+	  by the interrupts (GPS parsing, master updates and key tasks)
 		
 ***************************************************************************************************/
 
@@ -28,13 +29,13 @@ Vector2 tmp = {0,0};
 
 int main(void)
 {	
-	//APP_loadProgram();
-	
-	while(1){DDRA ^=(1<<0);}
-	
-
-	
+	APP_loadProgram();
 	
+	/* Service Deferred Work */
+	while(1){
+		GPS_service();		// Drain and parse received GPS bytes
+		APP_service();		// Run pending key task / master update
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -93,7 +94,7 @@ ISR(TIMER0_COMPA_vect)
 	/* Increment Towards Master Update */	// ***
 	static uint32_t count = 0;				// Initialize static count to 0
 	if(++count > MASTERUPDATETIME){			// Increment count / if has reached master update time,
-		APP_update_MASTER();				//  Execute master update
+		APP_flagUpdate();					//  Flag master update for the main loop
 		count = 0;							//  Reset count
 	}
 }
@@ -112,27 +113,49 @@ ISR(TIMER2_COMPB_vect)
 /***************************************************************************************************
 	USARTRXC - USART Receive-Data Interrupt
 	- Executes on request
-	- Processes/buffers GPS information from GPS module
+	- Enqueues GPS information from GPS module into GPS_RX (parsed by GPS_service)
 	
 ***************************************************************************************************/	
 ISR(USART0_RX_vect)
 {	
-	/* Buffer USART Data */
-	char vector_data = GPS_receive_byte();
+	/* Read Status Before Data */						// ***
+	uint8_t status = UCSR0A;							// Status MUST be read before UDR0
+	unsigned char data = UDR0;							// Read received byte
+	uint8_t next = (GPS_RX.head + 1) & GPS_RING_MASK;	// Calculate next head position
 	
-	/* Perform Data Analysis */								// ***
-	if(vector_data == '$'){									// If character is '$' (Sequence-Start Indicator),
-		GPS_MESSAGE_READY = 1;								//  Set flag to being filling buffer,
-		GPS_BUFFER[0] = '$';								//  Insert '$' into first buffer element and
-		GPS_BUFFER_INDEX = 1;								//  Set buffer index to 1 (index 0 = '$')
+	/* Enqueue USART Data */							// ***
+	if(status & (1<<DOR0)) GPS_RX.hw_overruns++;		// Count bytes lost in hardware
+	if(next == GPS_RX.tail){							// If ring is full,
+		GPS_RX.overruns++;								//  Count dropped byte
+		return;											//  Return
 	}
+	GPS_RX.buff[GPS_RX.head] = data;					// Store byte
+	GPS_RX.head = next;									// Publish byte to consumer
+}
+
+/***************************************************************************************************
+	USARTUDRE - USART Data-Register-Empty Interrupt
+	- Enabled by GPS_queue_P while GPS_TX holds unsent commands
+	- Sends queued PMTK commands to the GPS module straight from program memory
 	
-	else if((vector_data == '*') && (GPS_MESSAGE_READY)){	// Else, if character is '*' (Sequence-Terminating Indicator) and buffer is flagged to fill,
-		GPS_parse_V3();										//  Load SYS_GPS with updated information
+***************************************************************************************************/
+ISR(USART0_UDRE_vect)
+{
+	/* Send Next Byte of Oldest Unsent Command */		// ***
+	uint8_t send = GPS_TX.send;							// Slot being sent
+	while(send != GPS_TX.head){							// While a command is waiting,
+		if(!GPS_TX.next) GPS_TX.next = GPS_TX.slot[send].cmd;	//  Start it if new
+		unsigned char data = pgm_read_byte(GPS_TX.next);	//  Read next byte
+		if(data){										//  If not its terminator,
+			UDR0 = data;								//   Send byte
+			GPS_TX.next++;								//   Advance
+			return;										//   Return
+		}
+		GPS_TX.next = 0;								//  Command sent:
+		send = (send + 1) & GPS_CMD_MASK;				//  Move on to next slot
+		GPS_TX.send = send;								//  Hand it to the reply matcher
 	}
 	
-	else if(GPS_MESSAGE_READY){								// Else (no indicators detected), if buffer is flagged to fill,
-		GPS_BUFFER[GPS_BUFFER_INDEX] = vector_data;			//  Insert data into buffer and
-		GPS_BUFFER_INDEX++;									//  Increment buffer index
-	}
+	/* Queue Empty */									// ***
+	UCSR0B &= ~(1<<UDRIE0);								// Disable interrupt until next command
 }